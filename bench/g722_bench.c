@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Benchmark of the whole codec: encode and decode throughput for every
+ * rate, 8k/16k and packing mode, on one thread and scaled across several,
+ * plus the cost of the individual stages of the encoder and decoder.
+ * Every figure is the best of a number of trials, in ns per PCM sample.
+ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g722_private.h"
+#include "g722_common.h"
+#include "g722_quantl.h"
+#include "g722_encoder.h"
+#include "g722_decoder.h"
+
+#define SYNTH_LEN 160000
+#define MAX_SIGNALS 4
+
+struct mode {
+    int rate;
+    int options;
+};
+
+struct signal {
+    const char *name;
+    int16_t *pcm;
+    int len;
+};
+
+struct job {
+    const struct mode *mode;
+    const struct signal *sig;
+    const uint8_t *codes;
+    int ncodes;
+    int decode;
+    int block;
+};
+
+static const struct mode modes[] = {
+    {64000, 0},
+    {56000, 0},
+    {56000, G722_PACKED},
+    {48000, 0},
+    {48000, G722_PACKED},
+    {64000, G722_SAMPLE_RATE_8000},
+    {56000, G722_SAMPLE_RATE_8000},
+    {56000, G722_SAMPLE_RATE_8000 | G722_PACKED},
+    {48000, G722_SAMPLE_RATE_8000},
+    {48000, G722_SAMPLE_RATE_8000 | G722_PACKED},
+};
+#define NMODES (int)(sizeof(modes) / sizeof(modes[0]))
+
+static int json;
+static int trials = 5;
+static int first_result = 1;
+
+static void
+usage(const char *argv0)
+{
+
+    fprintf(stderr, "usage: %s [--json] [--threads N] [--trials N] [--block N]\n"
+      "       [--data DIR] [--no-stages]\n", argv0);
+    exit (1);
+}
+
+static double
+now(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER c, f;
+
+    QueryPerformanceCounter(&c);
+    QueryPerformanceFrequency(&f);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static int
+ncpus(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (n > 0) ? (int)n : 1;
+#endif
+}
+
+static const char *
+mode_name(const struct mode *m)
+{
+    static char buf[32];
+
+    snprintf(buf, sizeof(buf), "%dk/%s%s", m->rate / 1000,
+      (m->options & G722_SAMPLE_RATE_8000) ? "8k" : "16k",
+      (m->options & G722_PACKED) ? "/packed" : "");
+    return buf;
+}
+
+/* ITU test vectors are 16 bit big endian PCM */
+static int
+load_bend(const char *path, struct signal *sig)
+{
+    FILE *f;
+    uint8_t b[2];
+    long size;
+    int i;
+
+    if ((f = fopen(path, "rb")) == NULL)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    sig->len = (int)(size / 2);
+    sig->pcm = malloc(sig->len * sizeof(sig->pcm[0]));
+    for (i = 0; i < sig->len && fread(b, 1, 2, f) == 2; i++)
+        sig->pcm[i] = (int16_t)((b[0] << 8) | b[1]);
+    sig->len = i;
+    fclose(f);
+    return 0;
+}
+
+/* A few drifting partials under a syllabic envelope, plus a little noise */
+static void
+make_speech(struct signal *sig)
+{
+    uint32_t seed = 1;
+    double ph[3] = {0, 0, 0};
+    const double f[3] = {0.021, 0.057, 0.133};
+    int i, k;
+
+    sig->name = "speech";
+    sig->len = SYNTH_LEN;
+    sig->pcm = malloc(sig->len * sizeof(sig->pcm[0]));
+    for (i = 0; i < sig->len; i++) {
+        double v = 0, env;
+
+        for (k = 0; k < 3; k++) {
+            ph[k] += f[k] * (1.0 + 0.3 * ((i >> 11) % 5) / 5.0);
+            v += (ph[k] - (int)ph[k] < 0.5) ? 1.0 : -1.0;
+        }
+        env = ((i >> 12) & 1) ? 2500.0 : 9000.0;
+        seed = seed * 1103515245 + 12345;
+        sig->pcm[i] = (int16_t)(v * env + (int)((seed >> 16) & 0x3ff) - 512);
+    }
+}
+
+static void
+make_noise(struct signal *sig)
+{
+    uint32_t seed = 7;
+    int i;
+
+    sig->name = "noise";
+    sig->len = SYNTH_LEN;
+    sig->pcm = malloc(sig->len * sizeof(sig->pcm[0]));
+    for (i = 0; i < sig->len; i++) {
+        seed = seed * 1103515245 + 12345;
+        sig->pcm[i] = (int16_t)(seed >> 16);
+    }
+}
+
+static void
+make_silence(struct signal *sig)
+{
+
+    sig->name = "silence";
+    sig->len = SYNTH_LEN;
+    sig->pcm = calloc(sig->len, sizeof(sig->pcm[0]));
+}
+
+/* The codes for a signal, which is what the decoder gets to chew on */
+static uint8_t *
+encode_all(const struct mode *m, const struct signal *sig, int *ncodes)
+{
+    G722_ENC_CTX *s;
+    uint8_t *codes;
+
+    codes = malloc(sig->len);
+    s = g722_encoder_new(m->rate, m->options);
+    *ncodes = g722_encode(s, sig->pcm, sig->len, codes);
+    g722_encoder_destroy(s);
+    return codes;
+}
+
+/* One pass over the signal, as the RTP stack would do it, a block at a time */
+static void
+run_job(const struct job *job)
+{
+    static int16_t pcm_sink[2 * 8192];
+    static uint8_t code_sink[8192];
+    const struct mode *m = job->mode;
+    int i, n, chunk;
+
+    if (!job->decode) {
+        G722_ENC_CTX *s = g722_encoder_new(m->rate, m->options);
+
+        for (i = 0; i < job->sig->len; i += n) {
+            n = job->sig->len - i;
+            if (n > job->block)
+                n = job->block;
+            g722_encode(s, job->sig->pcm + i, n, code_sink);
+        }
+        g722_encoder_destroy(s);
+        return;
+    }
+
+    /* The bytes of one block of PCM */
+    chunk = (m->options & G722_SAMPLE_RATE_8000) ? job->block : job->block / 2;
+    if ((m->options & G722_PACKED) && m->rate != 64000)
+        chunk = chunk * (m->rate / 8000) / 8;
+    if (chunk < 1)
+        chunk = 1;
+    {
+        G722_DEC_CTX *s = g722_decoder_new(m->rate, m->options);
+
+        for (i = 0; i < job->ncodes; i += n) {
+            n = job->ncodes - i;
+            if (n > chunk)
+                n = chunk;
+            g722_decode(s, job->codes + i, n, pcm_sink);
+        }
+        g722_decoder_destroy(s);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI
+job_thread(LPVOID arg)
+{
+
+    run_job((const struct job *)arg);
+    return 0;
+}
+#else
+static void *
+job_thread(void *arg)
+{
+
+    run_job((const struct job *)arg);
+    return NULL;
+}
+#endif
+
+/* Best wall clock time of running the job on each of nthreads threads at once */
+static double
+time_job(const struct job *job, int nthreads)
+{
+    double t, best = 1e30;
+    int n, i;
+
+    for (n = 0; n < trials; n++) {
+        t = now();
+        if (nthreads <= 1) {
+            run_job(job);
+        } else {
+#if defined(_WIN32)
+            HANDLE *th = malloc(nthreads * sizeof(*th));
+
+            for (i = 0; i < nthreads; i++)
+                th[i] = CreateThread(NULL, 0, job_thread, (LPVOID)job, 0, NULL);
+            for (i = 0; i < nthreads; i++) {
+                WaitForSingleObject(th[i], INFINITE);
+                CloseHandle(th[i]);
+            }
+#else
+            pthread_t *th = malloc(nthreads * sizeof(*th));
+
+            for (i = 0; i < nthreads; i++)
+                pthread_create(&th[i], NULL, job_thread, (void *)job);
+            for (i = 0; i < nthreads; i++)
+                pthread_join(th[i], NULL);
+#endif
+            free(th);
+        }
+        t = now() - t;
+        if (t < best)
+            best = t;
+    }
+    return best;
+}
+
+static void
+report(const char *sig, const char *op, const struct mode *m, int nthreads,
+  double seconds, double samples)
+{
+    double ns = seconds * 1e9 / samples;
+
+    if (json) {
+        printf("%s\n    {\"signal\": \"%s\", \"op\": \"%s\", \"rate\": %d, "
+          "\"sample_rate\": %d, \"packed\": %s, \"threads\": %d, "
+          "\"ns_per_sample\": %.3f, \"msamples_per_s\": %.3f}",
+          first_result ? "" : ",", sig, op, m->rate,
+          (m->options & G722_SAMPLE_RATE_8000) ? 8000 : 16000,
+          (m->options & G722_PACKED) ? "true" : "false", nthreads, ns,
+          1e3 / ns);
+    } else {
+        printf("%-8s %-7s %-15s %7d %10.2f %12.2f\n", sig, op, mode_name(m),
+          nthreads, ns, 1e3 / ns);
+    }
+    first_result = 0;
+}
+
+static void
+report_stage(const char *stage, const char *unit, double ns)
+{
+
+    if (json) {
+        printf("%s\n    {\"stage\": \"%s\", \"unit\": \"%s\", \"ns\": %.3f}",
+          first_result ? "" : ",", stage, unit, ns);
+    } else {
+        printf("%-22s %10.2f ns per %s\n", stage, ns, unit);
+    }
+    first_result = 0;
+}
+
+static void
+bench_codec(struct signal *sigs, int nsigs, int block, int nthreads)
+{
+    struct job job;
+    double t;
+    int i, k, th;
+
+    if (!json) {
+        printf("%-8s %-7s %-15s %7s %10s %12s\n", "signal", "op", "mode",
+          "threads", "ns/sample", "Msamples/s");
+    }
+    for (i = 0; i < nsigs; i++) {
+        for (k = 0; k < NMODES; k++) {
+            memset(&job, 0, sizeof(job));
+            job.mode = &modes[k];
+            job.sig = &sigs[i];
+            job.block = block;
+            job.codes = encode_all(job.mode, job.sig, &job.ncodes);
+            for (th = 1; th <= nthreads; th = (th == nthreads) ? th + 1 : nthreads) {
+                job.decode = 0;
+                t = time_job(&job, th);
+                report(sigs[i].name, "encode", job.mode, th, t,
+                  (double)sigs[i].len * th);
+                job.decode = 1;
+                t = time_job(&job, th);
+                report(sigs[i].name, "decode", job.mode, th, t,
+                  (double)sigs[i].len * th);
+            }
+            free((void *)job.codes);
+        }
+    }
+}
+
+/* Best time of running fn(arg) over the trials, in ns per item */
+static double
+time_stage(void (*fn)(void *), void *arg, int items)
+{
+    double t, best = 1e30;
+    int n;
+
+    for (n = 0; n < trials; n++) {
+        t = now();
+        fn(arg);
+        t = now() - t;
+        if (t < best)
+            best = t;
+    }
+    return best * 1e9 / items;
+}
+
+struct stage_data {
+    const struct signal *sig;
+    int16_t *out;
+    int *wd;
+    int *det;
+    int16_t *d;
+    int n;
+    volatile int sink;
+};
+
+static void
+stage_qmf(void *arg, int rx)
+{
+    struct stage_data *sd = arg;
+    int16_t xbuf[G722_QMF_HIST + 2 * G722_QMF_BLOCK];
+    g722_qmf_fn qmf = g722_qmf_select();
+    int i, pairs;
+
+    memset(xbuf, 0, sizeof(xbuf));
+    for (i = 0; i + 2 <= sd->sig->len; i += 2 * pairs) {
+        pairs = (sd->sig->len - i) / 2;
+        if (pairs > G722_QMF_BLOCK)
+            pairs = G722_QMF_BLOCK;
+        memcpy(xbuf + G722_QMF_HIST, sd->sig->pcm + i, 2 * pairs * sizeof(xbuf[0]));
+        if (rx)
+            qmf(xbuf, pairs, 11, &g722_qmf_rx_taps, sd->out + i);
+        else
+            qmf(xbuf, pairs, 14, &g722_qmf_tx_taps, sd->out + i);
+        memcpy(xbuf, xbuf + 2 * pairs, G722_QMF_HIST * sizeof(xbuf[0]));
+    }
+}
+
+static void
+stage_qmf_tx(void *arg)
+{
+
+    stage_qmf(arg, 0);
+}
+
+static void
+stage_qmf_rx(void *arg)
+{
+
+    stage_qmf(arg, 1);
+}
+
+static void
+stage_quantl(void *arg)
+{
+    struct stage_data *sd = arg;
+    int i, acc = 0;
+
+    for (i = 0; i < sd->n; i++)
+        acc += g722_quantl_index(sd->wd[i], sd->det[i]);
+    sd->sink = acc;
+}
+
+static void
+stage_block4(void *arg)
+{
+    struct stage_data *sd = arg;
+    struct g722_band band;
+    int i;
+
+    memset(&band, 0, sizeof(band));
+    for (i = 0; i < sd->n; i++)
+        block4(&band, sd->d[i]);
+    sd->sink = band.s;
+}
+
+static void
+bench_stages(const struct signal *sig, int block)
+{
+    struct stage_data sd;
+    struct job job;
+    G722_ENC_CTX *s;
+    int i, ncodes;
+    double plain, packed;
+
+    memset(&sd, 0, sizeof(sd));
+    sd.sig = sig;
+    sd.out = malloc(sig->len * sizeof(sd.out[0]));
+    report_stage("qmf_tx", "sample", time_stage(stage_qmf_tx, &sd, sig->len));
+    report_stage("qmf_rx", "sample", time_stage(stage_qmf_rx, &sd, sig->len));
+
+    /* What QUANTL and block 4 get to see, from an 8k encoder where xlow is just amp >> 1 */
+    sd.n = sig->len;
+    sd.wd = malloc(sd.n * sizeof(sd.wd[0]));
+    sd.det = malloc(sd.n * sizeof(sd.det[0]));
+    sd.d = malloc(sd.n * sizeof(sd.d[0]));
+    s = g722_encoder_new(64000, G722_SAMPLE_RATE_8000);
+    for (i = 0; i < sd.n; i++) {
+        int el = saturate((sig->pcm[i] >> 1) - s->band[0].s);
+        uint8_t code;
+
+        sd.wd[i] = (el >= 0) ? el : -(el + 1);
+        sd.det[i] = s->band[0].det;
+        g722_encode(s, &sig->pcm[i], 1, &code);
+        sd.d[i] = s->band[0].d[1];
+    }
+    g722_encoder_destroy(s);
+    report_stage("quantl", "code", time_stage(stage_quantl, &sd, sd.n));
+    report_stage("block4", "band update", time_stage(stage_block4, &sd, sd.n));
+
+    /* Packing is inline in the codec, so it is the packed mode less the plain one */
+    memset(&job, 0, sizeof(job));
+    job.sig = sig;
+    job.block = block;
+    for (i = 0; i < 2; i++) {
+        job.decode = i;
+        job.mode = &modes[3];
+        job.codes = encode_all(job.mode, sig, &job.ncodes);
+        plain = time_job(&job, 1);
+        free((void *)job.codes);
+        job.mode = &modes[4];
+        job.codes = encode_all(job.mode, sig, &ncodes);
+        job.ncodes = ncodes;
+        packed = time_job(&job, 1);
+        free((void *)job.codes);
+        /* One code per 2 samples */
+        report_stage(i ? "unpacking_48k" : "packing_48k", "code",
+          (packed - plain) * 1e9 / (sig->len / 2));
+    }
+    free(sd.out);
+    free(sd.wd);
+    free(sd.det);
+    free(sd.d);
+}
+
+int
+main(int argc, char **argv)
+{
+    struct signal sigs[MAX_SIGNALS];
+    const char *data = "test_data";
+    char path[1024];
+    int nsigs, nthreads, block, stages;
+    int argi, i;
+
+    nthreads = ncpus();
+    block = 160;
+    stages = 1;
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[argi], "--no-stages") == 0) {
+            stages = 0;
+        } else if (strcmp(argv[argi], "--threads") == 0 && argi + 1 < argc) {
+            nthreads = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--trials") == 0 && argi + 1 < argc) {
+            trials = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--block") == 0 && argi + 1 < argc) {
+            block = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--data") == 0 && argi + 1 < argc) {
+            data = argv[++argi];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (nthreads < 1 || trials < 1 || block < 2 || block > 8192)
+        usage(argv[0]);
+
+    nsigs = 0;
+    snprintf(path, sizeof(path), "%s/pcminb.dat", data);
+    if (load_bend(path, &sigs[nsigs]) == 0) {
+        sigs[nsigs++].name = "pcminb";
+    } else if (!json) {
+        fprintf(stderr, "%s not found, using synthetic signals only\n", path);
+    }
+    make_speech(&sigs[nsigs++]);
+    make_noise(&sigs[nsigs++]);
+    make_silence(&sigs[nsigs++]);
+
+    if (json)
+        printf("{\n  \"cpus\": %d, \"trials\": %d, \"block\": %d,\n  \"results\": [", ncpus(), trials, block);
+    bench_codec(sigs, nsigs, block, nthreads);
+    if (json)
+        printf("\n  ]");
+    if (stages) {
+        first_result = 1;
+        if (json)
+            printf(",\n  \"stages\": [");
+        else
+            printf("\n");
+        /* The synthetic speech, as it is the longest */
+        bench_stages(&sigs[nsigs - 3], block);
+        if (json)
+            printf("\n  ]");
+    }
+    if (json)
+        printf("\n}\n");
+    for (i = 0; i < nsigs; i++)
+        free(sigs[i].pcm);
+    return 0;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Benchmark of the batch engine: a media server's worth of 16k G.722 calls,
+ * each encoding and decoding one 20 ms frame per tick, with a tick run as
+ * one batch. The same load is timed on engines of 1 thread up to one per
+ * CPU, to show how it scales. Every figure is the best of a number of
+ * trials.
+ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g722_encoder.h"
+#include "g722_decoder.h"
+#include "g722_engine.h"
+
+/* 20 ms at 16k samples/second */
+#define FRAME_SAMPLES 320
+#define FRAME_BYTES (FRAME_SAMPLES / 2)
+#define SYNTH_LEN 160000
+
+struct channel {
+    G722_ENC_CTX *enc;
+    G722_DEC_CTX *dec;
+    /* Where this call is in the signal */
+    int pos;
+    /* The frame being encoded, and the one encoded on the tick before */
+    uint8_t codes[2][FRAME_BYTES];
+    int16_t pcm[FRAME_SAMPLES];
+};
+
+static int json;
+static int trials = 3;
+static int first_result = 1;
+
+static void
+usage(const char *argv0)
+{
+
+    fprintf(stderr, "usage: %s [--json] [--threads N] [--trials N] [--channels N]\n"
+      "       [--ticks N] [--no-pin] [--data DIR]\n", argv0);
+    exit (1);
+}
+
+static double
+now(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER c, f;
+
+    QueryPerformanceCounter(&c);
+    QueryPerformanceFrequency(&f);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static int
+ncpus(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (n > 0) ? (int)n : 1;
+#endif
+}
+
+/* ITU test vectors are 16 bit big endian PCM */
+static int16_t *
+load_bend(const char *path, int *len)
+{
+    FILE *f;
+    uint8_t b[2];
+    int16_t *pcm;
+    long size;
+    int i;
+
+    if ((f = fopen(path, "rb")) == NULL)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    pcm = malloc(size / 2 * sizeof(pcm[0]));
+    for (i = 0; i < size / 2 && fread(b, 1, 2, f) == 2; i++)
+        pcm[i] = (int16_t)((b[0] << 8) | b[1]);
+    fclose(f);
+    *len = i;
+    return pcm;
+}
+
+/* Drifting partials and a little noise, should the test vector be missing */
+static int16_t *
+make_speech(int *len)
+{
+    uint32_t seed = 1;
+    int16_t *pcm;
+    int i;
+
+    *len = SYNTH_LEN;
+    pcm = malloc(*len * sizeof(pcm[0]));
+    for (i = 0; i < *len; i++) {
+        int v = ((i * 21 / 1000) & 1) ? 6000 : -6000;
+
+        v += ((i * 57 / 1000) & 1) ? 3000 : -3000;
+        seed = seed * 1103515245 + 12345;
+        pcm[i] = (int16_t)(v + (int)((seed >> 16) & 0x3ff) - 512);
+    }
+    return pcm;
+}
+
+/*
+ * One tick: every channel encodes its next frame of the signal and decodes
+ * the frame its encoder made on the tick before, as the two directions of
+ * a call would. The jobs are on different contexts, so they may run at the
+ * same time, and the two frames alternate between buffers by tick.
+ */
+static void
+run_tick(G722_ENGINE *e, struct channel *ch, int nch, struct g722_job *jobs,
+  const int16_t *pcm, int len, unsigned int tick)
+{
+    int i;
+
+    for (i = 0; i < nch; i++) {
+        jobs[2 * i] = (struct g722_job){G722_JOB_DECODE, ch[i].dec,
+          ch[i].codes[(tick + 1) & 1], FRAME_BYTES, ch[i].pcm, 0};
+        jobs[2 * i + 1] = (struct g722_job){G722_JOB_ENCODE, ch[i].enc,
+          pcm + ch[i].pos, FRAME_SAMPLES, ch[i].codes[tick & 1], 0};
+        ch[i].pos += FRAME_SAMPLES;
+        if (ch[i].pos + FRAME_SAMPLES > len)
+            ch[i].pos = 0;
+    }
+    if (g722_engine_run(e, jobs, 2 * nch) != 0) {
+        fprintf(stderr, "g722_engine_run() failed\n");
+        exit (1);
+    }
+}
+
+static void
+report(int nthreads, int nch, int ticks, double seconds, double base)
+{
+    /* Each channel does a frame of each direction per tick */
+    double us = seconds * 1e6 / ((double)nch * ticks);
+    double rt = 0.020 * ticks / seconds;
+
+    if (json) {
+        printf("%s\n    {\"threads\": %d, \"channels\": %d, \"ticks\": %d, "
+          "\"us_per_channel_frame\": %.3f, \"realtime_channels\": %.0f, "
+          "\"speedup\": %.2f}",
+          first_result ? "" : ",", nthreads, nch, ticks, us, rt * nch,
+          base / seconds);
+    } else {
+        printf("%7d %10d %18.3f %18.0f %8.2f\n", nthreads, nch, us, rt * nch,
+          base / seconds);
+    }
+    first_result = 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *data = "test_data";
+    char path[1024];
+    struct channel *ch;
+    struct g722_job *jobs;
+    G722_ENGINE *e;
+    int16_t *pcm;
+    int len, nthreads, nch, ticks, options;
+    int argi, i, n, th, tick;
+    unsigned int ntick;
+    double t, best, base;
+
+    nthreads = ncpus();
+    nch = 10000;
+    ticks = 50;
+    options = 0;
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[argi], "--no-pin") == 0) {
+            options |= G722_ENGINE_NO_PIN;
+        } else if (strcmp(argv[argi], "--threads") == 0 && argi + 1 < argc) {
+            nthreads = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--trials") == 0 && argi + 1 < argc) {
+            trials = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--channels") == 0 && argi + 1 < argc) {
+            nch = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--ticks") == 0 && argi + 1 < argc) {
+            ticks = atoi(argv[++argi]);
+        } else if (strcmp(argv[argi], "--data") == 0 && argi + 1 < argc) {
+            data = argv[++argi];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (nthreads < 1 || trials < 1 || nch < 1 || ticks < 1)
+        usage(argv[0]);
+
+    snprintf(path, sizeof(path), "%s/pcminb.dat", data);
+    if ((pcm = load_bend(path, &len)) == NULL || len < 2 * FRAME_SAMPLES) {
+        if (!json)
+            fprintf(stderr, "%s not found, using a synthetic signal\n", path);
+        free(pcm);
+        pcm = make_speech(&len);
+    }
+
+    ch = calloc(nch, sizeof(ch[0]));
+    jobs = malloc(2 * nch * sizeof(jobs[0]));
+    if (ch == NULL || jobs == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit (1);
+    }
+    for (i = 0; i < nch; i++) {
+        ch[i].enc = g722_encoder_new(64000, 0);
+        ch[i].dec = g722_decoder_new(64000, 0);
+        if (ch[i].enc == NULL || ch[i].dec == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit (1);
+        }
+        /* Spread the calls over the signal, so they are not all in step */
+        ch[i].pos = (int)((uint64_t)i * 7919 * FRAME_SAMPLES % (len - FRAME_SAMPLES));
+    }
+
+    if (json) {
+        printf("{\n  \"cpus\": %d, \"trials\": %d, \"frame_ms\": 20,\n  \"results\": [",
+          ncpus(), trials);
+    } else {
+        printf("%7s %10s %18s %18s %8s\n", "threads", "channels",
+          "us/channel-frame", "realtime channels", "speedup");
+    }
+    base = 0;
+    ntick = 0;
+    for (th = 1; th <= nthreads; th = (th == nthreads) ? th + 1 : (2 * th < nthreads ? 2 * th : nthreads)) {
+        if ((e = g722_engine_new(th, options)) == NULL) {
+            fprintf(stderr, "g722_engine_new() failed\n");
+            exit (1);
+        }
+        /* Once round to fault everything in */
+        run_tick(e, ch, nch, jobs, pcm, len, ntick++);
+        best = 1e30;
+        for (n = 0; n < trials; n++) {
+            t = now();
+            for (tick = 0; tick < ticks; tick++)
+                run_tick(e, ch, nch, jobs, pcm, len, ntick++);
+            t = now() - t;
+            if (t < best)
+                best = t;
+        }
+        g722_engine_destroy(e);
+        if (base == 0)
+            base = best;
+        report(th, nch, ticks, best, base);
+    }
+    if (json)
+        printf("\n  ]\n}\n");
+
+    for (i = 0; i < nch; i++) {
+        g722_encoder_destroy(ch[i].enc);
+        g722_decoder_destroy(ch[i].dec);
+    }
+    free(ch);
+    free(jobs);
+    free(pcm);
+    return 0;
+}
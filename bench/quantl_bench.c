@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Microbenchmark of the block 1L QUANTL search: the linear scan of the
+ * original code against g722_quantl_index(), over the (wd, det) pairs an
+ * encoder actually sees, followed by the whole encoder at each bit rate.
+ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g722_private.h"
+#include "g722_common.h"
+#include "g722_quantl.h"
+#include "g722_encoder.h"
+
+#define TRACE_LEN 65536
+#define SIGNAL_LEN 160000
+#define TRIALS 7
+
+static double
+now(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER c, f;
+
+    QueryPerformanceCounter(&c);
+    QueryPerformanceFrequency(&f);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/* Something speech like: a few drifting partials under a syllabic envelope, plus noise */
+static void
+make_signal(int16_t *amp, int len)
+{
+    uint32_t seed = 1;
+    double ph[3] = {0, 0, 0};
+    const double f[3] = {0.021, 0.057, 0.133};
+    int i, k;
+
+    for (i = 0; i < len; i++) {
+        double v = 0, env;
+
+        for (k = 0; k < 3; k++) {
+            ph[k] += f[k] * (1.0 + 0.3 * ((i >> 11) % 5) / 5.0);
+            v += (ph[k] - (int)ph[k] < 0.5) ? 1.0 : -1.0;
+        }
+        env = ((i >> 12) & 1) ? 2500.0 : 9000.0;
+        seed = seed * 1103515245 + 12345;
+        amp[i] = (int16_t)(v * env + (int)((seed >> 16) & 0x3ff) - 512);
+    }
+}
+
+static int
+quantl_linear(int wd, int det)
+{
+    int i;
+
+    for (i = 1; i < 30; i++) {
+        if (wd < ((g722_tables.q6[i] * det) >> 12))
+            break;
+    }
+    return i;
+}
+
+int
+main(void)
+{
+    static int16_t amp[SIGNAL_LEN];
+    static uint8_t out[SIGNAL_LEN];
+    static int wd[TRACE_LEN], det[TRACE_LEN];
+    static const int rates[3] = {48000, 56000, 64000};
+    G722_ENC_CTX *s;
+    double t, best_linear, best_search, gain;
+    volatile int sink;
+    int i, n, r, acc;
+
+    make_signal(amp, SIGNAL_LEN);
+
+    /* Record what QUANTL sees, from an 8k encoder where xlow is just amp >> 1 */
+    s = g722_encoder_new(64000, G722_SAMPLE_RATE_8000);
+    for (i = 0; i < TRACE_LEN; i++) {
+        int el = saturate((amp[i] >> 1) - s->band[0].s);
+
+        wd[i] = (el >= 0) ? el : -(el + 1);
+        det[i] = s->band[0].det;
+        g722_encode(s, &amp[i], 1, out);
+    }
+    g722_encoder_destroy(s);
+
+    for (i = 0; i < TRACE_LEN; i++) {
+        if (quantl_linear(wd[i], det[i]) != g722_quantl_index(wd[i], det[i])) {
+            fprintf(stderr, "mismatch at wd=%d det=%d\n", wd[i], det[i]);
+            exit(1);
+        }
+    }
+
+    best_linear = best_search = 1e9;
+    for (n = 0; n < TRIALS; n++) {
+        acc = 0;
+        t = now();
+        for (i = 0; i < TRACE_LEN; i++)
+            acc += quantl_linear(wd[i], det[i]);
+        t = now() - t;
+        sink = acc;
+        if (t < best_linear)
+            best_linear = t;
+
+        acc = 0;
+        t = now();
+        for (i = 0; i < TRACE_LEN; i++)
+            acc += g722_quantl_index(wd[i], det[i]);
+        t = now() - t;
+        sink = acc;
+        if (t < best_search)
+            best_search = t;
+    }
+    (void)sink;
+    best_linear *= 1e9 / TRACE_LEN;
+    best_search *= 1e9 / TRACE_LEN;
+    gain = best_linear - best_search;
+    printf("QUANTL linear scan %.2f ns, search %.2f ns, %.2f ns saved per code\n",
+      best_linear, best_search, gain);
+
+    /* One QUANTL per code, so half the saving per 16k input sample. The
+       search does not depend on the rate, only the rest of the encoder does. */
+    printf("%-6s %12s %12s %8s\n", "rate", "ns/sample", "saved", "share");
+    for (r = 0; r < 3; r++) {
+        double best = 1e9;
+
+        for (n = 0; n < TRIALS; n++) {
+            s = g722_encoder_new(rates[r], 0);
+            t = now();
+            g722_encode(s, amp, SIGNAL_LEN, out);
+            t = now() - t;
+            g722_encoder_destroy(s);
+            if (t < best)
+                best = t;
+        }
+        best *= 1e9 / SIGNAL_LEN;
+        printf("%-6d %12.2f %12.2f %7.1f%%\n", rates[r], best, gain / 2,
+          100.0 * gain / 2 / (best + gain / 2));
+    }
+    return 0;
+}
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -49,7 +50,49 @@ enum
 {
     G722_DEFAULT = 0x0000,
     G722_SAMPLE_RATE_8000 = 0x0001,
-    G722_PACKED = 0x0002
+    G722_PACKED = 0x0002,
+    /*! Make room in the context for g722_encode_48khz() or
+        g722_decode_48khz(), which other contexts are spared */
+    G722_RESAMPLE_48000 = 0x0004
+};
+
+/*! The alignment, in bytes, of the memory given to g722_encoder_init() and
+    g722_decoder_init(). Any cache line aligned memory will do. */
+#define G722_STATE_ALIGN 8
+
+/*! The counters a context keeps when the library is built with
+    G722_ENABLE_STATS, as g722_encoder_get_stats() and
+    g722_decoder_get_stats() return them. Everything counts from when the
+    context was set up. The clips and limits are those of the blocks
+    actually run, so the codes a fast path takes add none. */
+struct g722_stats
+{
+    /*! Calls made to encode or decode */
+    uint64_t calls;
+    /*! Samples in to the encoder, or out of the decoder, at the rate of each call */
+    uint64_t samples;
+    /*! Linear samples at INT16_MIN or INT16_MAX, a sign of clipping ahead
+        of the encoder or in the decoder's output */
+    uint64_t full_scale;
+    /*! G.722 codes out of the encoder, or in to the decoder */
+    uint64_t codes;
+    /*! Codes the encoder made from digital silence, without the transmit QMF */
+    uint64_t silent_codes;
+    /*! Codes that found the state settled: the encoder skipping the high
+        band of silence, or the decoder replaying an idle code's output */
+    uint64_t idle_codes;
+    /*! Values clipped to 16 bits, by the ADPCM blocks, the QMF, and the
+        resampler of the 48k calls */
+    uint64_t saturations;
+    /*! Times the scale factor was limited, by block 3L then block 3H */
+    uint64_t nb_limits[2];
+    /*! Times the decoder's reconstructed signal was limited, by block 6L
+        then block 6H */
+    uint64_t signal_limits[2];
+    /*! The low, then the high, band scale factor after each code, in steps of 2048 */
+    uint64_t nb_hist[2][12];
+    /*! The codes, as sent, with the high band bits at the top */
+    uint64_t code_hist[256];
 };
 
 #ifdef __cplusplus
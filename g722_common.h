@@ -27,6 +27,10 @@
 
 #pragma once
 
+#include <string.h>
+
+#include "g722_tables.h"
+
 #if !defined(FALSE)
 #define FALSE 0
 #endif
@@ -34,6 +38,101 @@
 #define TRUE (!FALSE)
 #endif
 
+/* For the bodies of the mode specialised loops, which must fold away */
+#if defined(_MSC_VER)
+#define G722_ALWAYS_INLINE __forceinline
+#else
+#define G722_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+/* With G722_ENABLE_STATS the statistics counters are kept, and G722_STATS()
+   keeps its arguments. Without it, they go and nothing is left. */
+#if defined(G722_ENABLE_STATS)
+#define G722_STATS(...) __VA_ARGS__
+#if defined(_MSC_VER)
+#define G722_THREAD_LOCAL __declspec(thread)
+#else
+#define G722_THREAD_LOCAL __thread
+#endif
+
+/* Clips and limits in the blocks that only see a band or a signal, such as
+   the ones below, the QMFs and the resampler. They are counted here, one
+   tally per thread, from the start of an encoder or decoder call until it
+   collects them into its context at the end. */
+struct g722_tally
+{
+    uint32_t saturations;
+    uint32_t nb_limits[2];
+    uint32_t signal_limits[2];
+};
+
+extern G722_THREAD_LOCAL struct g722_tally g722_tally;
+
+#define G722_TALLY(x) (g722_tally.x++)
+
+/* Drop whatever was tallied outside an encoder or decoder call, such as by
+   the multi-channel coder's QMFs */
+static inline void g722_tally_reset(void)
+{
+    memset(&g722_tally, 0, sizeof(g722_tally));
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Move the tally into the counters of the context that ran up the tally */
+static inline void g722_tally_collect(struct g722_stats *stats)
+{
+    stats->saturations += g722_tally.saturations;
+    stats->nb_limits[0] += g722_tally.nb_limits[0];
+    stats->nb_limits[1] += g722_tally.nb_limits[1];
+    stats->signal_limits[0] += g722_tally.signal_limits[0];
+    stats->signal_limits[1] += g722_tally.signal_limits[1];
+    g722_tally_reset();
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Count a run of codes */
+static inline void g722_stats_codes(struct g722_stats *stats, const uint8_t c[], int n)
+{
+    int i;
+
+    stats->codes += n;
+    for (i = 0;  i < n;  i++)
+        stats->code_hist[c[i]]++;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Count n codes that left the bands with their scale factors as they are */
+static inline void g722_stats_nb(struct g722_stats *stats, const struct g722_band band[], int n, int eight_k)
+{
+    stats->nb_hist[0][band[0].nb >> 11] += n;
+    if (!eight_k)
+        stats->nb_hist[1][band[1].nb >> 11] += n;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Count the linear samples of a call */
+static inline void g722_stats_samples(struct g722_stats *stats, const int16_t amp[], int len)
+{
+    int i;
+
+    stats->calls++;
+    if (len <= 0)
+        return;
+    stats->samples += len;
+    if (amp == NULL)
+        return;
+    for (i = 0;  i < len;  i++)
+    {
+        if (amp[i] == INT16_MAX  ||  amp[i] == INT16_MIN)
+            stats->full_scale++;
+    }
+}
+/*- End of function --------------------------------------------------------*/
+#else
+#define G722_STATS(...)
+#define G722_TALLY(x)
+#endif
+
 static inline int16_t saturate(int32_t amp)
 {
     int16_t amp16;
@@ -42,97 +141,198 @@ static inline int16_t saturate(int32_t amp)
     amp16 = (int16_t) amp;
     if (amp == amp16)
         return amp16;
+    G722_TALLY(saturations);
     if (amp > INT16_MAX)
         return  INT16_MAX;
     return  INT16_MIN;
 }
 /*- End of function --------------------------------------------------------*/
 
-static inline void block4(struct g722_band *band, int d)
+/* Blocks 3L, LOGSCL and SCALEL, for the low band code ril */
+static inline void g722_adapt_low(struct g722_band *band, int ril)
+{
+    int wd;
+
+    wd = ((band->nb*127) >> 7) + g722_tables.wl_ril[ril];
+    if (wd < 0)
+    {
+        wd = 0;
+        G722_TALLY(nb_limits[0]);
+    }
+    else if (wd > 18432)
+    {
+        wd = 18432;
+        G722_TALLY(nb_limits[0]);
+    }
+    band->nb = (int16_t) wd;
+    band->det = g722_tables.det[(wd >> 6) + 64];
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Blocks 3H, LOGSCH and SCALEH, for the high band code ihigh */
+static inline void g722_adapt_high(struct g722_band *band, int ihigh)
+{
+    int wd;
+
+    wd = ((band->nb*127) >> 7) + g722_tables.wh_ih[ihigh];
+    if (wd < 0)
+    {
+        wd = 0;
+        G722_TALLY(nb_limits[1]);
+    }
+    else if (wd > 22528)
+    {
+        wd = 22528;
+        G722_TALLY(nb_limits[1]);
+    }
+    band->nb = (int16_t) wd;
+    band->det = g722_tables.det[wd >> 6];
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Little endian 64 bit loads and stores, at any alignment */
+static inline uint64_t g722_load_le64(const uint8_t *p)
+{
+#if (defined(__BYTE_ORDER__)  &&  __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)  ||  defined(_MSC_VER)
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    uint64_t v;
+    int i;
+
+    v = 0;
+    for (i = 7;  i >= 0;  i--)
+        v = (v << 8) | p[i];
+    return v;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline void g722_store_le64(uint8_t *p, uint64_t v)
 {
+#if (defined(__BYTE_ORDER__)  &&  __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)  ||  defined(_MSC_VER)
+    memcpy(p, &v, sizeof(v));
+#else
+    int i;
+
+    for (i = 0;  i < 8;  i++)
+        p[i] = (uint8_t) (v >> 8*i);
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Block 4 for nbands bands, the low band first. The bands do not depend
+   on each other, so each stage is run for all of them before the next,
+   interleaving their dependency chains. UPZERO, DELAYA and FILTEZ make a
+   single pass over the taps.
+
+   Some of the saturations of the ITU description can never act, and are
+   left out. With det at most 16384, and qm4[] and qm2[] at most 20456,
+   |d| is at most 10228, so 2d fits in 16 bits. |a2| is at most 12288, so
+   15360 - a2 fits in 16 bits, and |a1| is at most 15360 + 12288. UPPOL1
+   then sums to at most 192 + 27648. For any 16 bit b, (b*32640) >> 15
+   plus or minus 128 stays within 16 bits in UPZERO. */
+static G722_ALWAYS_INLINE void block4_bands(struct g722_band band[], const int d[], const int nbands)
+{
+    int r0[2];
+    int p0[2];
+    int ap1[2];
+    int ap2[2];
+    int sz[2];
+    int sg0;
+    int sg1;
+    int sg2;
     int wd1;
     int wd2;
     int wd3;
+    int dd;
     int i;
+    int k;
 
-    /* Block 4, RECONS */
-    band->d[0] = d;
-    band->r[0] = saturate(band->s + d);
-
-    /* Block 4, PARREC */
-    band->p[0] = saturate(band->sz + d);
-
-    /* Block 4, UPPOL2 */
-    for (i = 0;  i < 3;  i++)
-        band->sg[i] = band->p[i] >> 15;
-    wd1 = saturate(band->a[1] << 2);
-
-    wd2 = (band->sg[0] == band->sg[1])  ?  -wd1  :  wd1;
-    if (wd2 > 32767)
-        wd2 = 32767;
-    wd3 = (wd2 >> 7) + ((band->sg[0] == band->sg[2])  ?  128  :  -128);
-    wd3 += (band->a[2]*32512) >> 15;
-    if (wd3 > 12288)
-        wd3 = 12288;
-    else if (wd3 < -12288)
-        wd3 = -12288;
-    band->ap[2] = wd3;
-
-    /* Block 4, UPPOL1 */
-    band->sg[0] = band->p[0] >> 15;
-    band->sg[1] = band->p[1] >> 15;
-    wd1 = (band->sg[0] == band->sg[1])  ?  192  :  -192;
-    wd2 = (band->a[1]*32640) >> 15;
-
-    band->ap[1] = saturate(wd1 + wd2);
-    wd3 = saturate(15360 - band->ap[2]);
-    if (band->ap[1] > wd3)
-        band->ap[1] = wd3;
-    else if (band->ap[1] < -wd3)
-        band->ap[1] = -wd3;
-
-    /* Block 4, UPZERO */
-    wd1 = (d == 0)  ?  0  :  128;
-    band->sg[0] = d >> 15;
-    for (i = 1;  i < 7;  i++)
+    for (k = 0;  k < nbands;  k++)
     {
-        band->sg[i] = band->d[i] >> 15;
-        wd2 = (band->sg[i] == band->sg[0])  ?  wd1  :  -wd1;
-        wd3 = (band->b[i]*32640) >> 15;
-        band->bp[i] = saturate(wd2 + wd3);
+        /* Block 4, RECONS */
+        r0[k] = saturate(band[k].s + d[k]);
+
+        /* Block 4, PARREC */
+        p0[k] = saturate(band[k].sz + d[k]);
     }
 
-    /* Block 4, DELAYA */
-    for (i = 6;  i > 0;  i--)
+    for (k = 0;  k < nbands;  k++)
     {
-        band->d[i] = band->d[i - 1];
-        band->b[i] = band->bp[i];
+        /* Block 4, UPPOL2 */
+        sg0 = p0[k] >> 15;
+        sg1 = band[k].p[1] >> 15;
+        sg2 = band[k].p[2] >> 15;
+        wd1 = saturate(band[k].a[1] << 2);
+
+        wd2 = (sg0 == sg1)  ?  -wd1  :  wd1;
+        if (wd2 > 32767)
+            wd2 = 32767;
+        wd3 = (wd2 >> 7) + ((sg0 == sg2)  ?  128  :  -128);
+        wd3 += (band[k].a[2]*32512) >> 15;
+        if (wd3 > 12288)
+            wd3 = 12288;
+        else if (wd3 < -12288)
+            wd3 = -12288;
+        ap2[k] = wd3;
+
+        /* Block 4, UPPOL1 */
+        wd1 = (sg0 == sg1)  ?  192  :  -192;
+        wd2 = (band[k].a[1]*32640) >> 15;
+
+        ap1[k] = wd1 + wd2;
+        wd3 = 15360 - ap2[k];
+        if (ap1[k] > wd3)
+            ap1[k] = wd3;
+        else if (ap1[k] < -wd3)
+            ap1[k] = -wd3;
     }
-    
-    for (i = 2;  i > 0;  i--)
+
+    for (k = 0;  k < nbands;  k++)
     {
-        band->r[i] = band->r[i - 1];
-        band->p[i] = band->p[i - 1];
-        band->a[i] = band->ap[i];
+        /* Block 4, UPZERO, DELAYA and FILTEZ */
+        wd1 = (d[k] == 0)  ?  0  :  128;
+        sg0 = d[k] >> 15;
+        sz[k] = 0;
+        for (i = 6;  i > 0;  i--)
+        {
+            dd = (i > 1)  ?  band[k].d[i - 1]  :  d[k];
+            wd2 = ((band[k].d[i] >> 15) == sg0)  ?  wd1  :  -wd1;
+            wd3 = (band[k].b[i]*32640) >> 15;
+            band[k].b[i] = (int16_t) (wd2 + wd3);
+            band[k].d[i] = (int16_t) dd;
+            sz[k] += (band[k].b[i]*(dd + dd)) >> 15;
+        }
     }
 
-    /* Block 4, FILTEP */
-    wd1 = saturate(band->r[1] + band->r[1]);
-    wd1 = (band->a[1]*wd1) >> 15;
-    wd2 = saturate(band->r[2] + band->r[2]);
-    wd2 = (band->a[2]*wd2) >> 15;
-    band->sp = saturate(wd1 + wd2);
-
-    /* Block 4, FILTEZ */
-    band->sz = 0;
-    for (i = 6;  i > 0;  i--)
+    for (k = 0;  k < nbands;  k++)
     {
-        wd1 = saturate(band->d[i] + band->d[i]);
-        band->sz += (band->b[i]*wd1) >> 15;
+        /* Block 4, DELAYA */
+        band[k].r[2] = band[k].r[1];
+        band[k].r[1] = (int16_t) r0[k];
+        band[k].p[2] = band[k].p[1];
+        band[k].p[1] = (int16_t) p0[k];
+        band[k].a[1] = (int16_t) ap1[k];
+        band[k].a[2] = (int16_t) ap2[k];
+
+        /* Block 4, FILTEP */
+        wd1 = saturate(band[k].r[1] + band[k].r[1]);
+        wd1 = (band[k].a[1]*wd1) >> 15;
+        wd2 = saturate(band[k].r[2] + band[k].r[2]);
+        wd2 = (band[k].a[2]*wd2) >> 15;
+
+        /* Block 4, PREDIC */
+        band[k].sz = saturate(sz[k]);
+        band[k].s = saturate(saturate(wd1 + wd2) + band[k].sz);
     }
-    band->sz = saturate(band->sz);
+}
+/*- End of function --------------------------------------------------------*/
 
-    /* Block 4, PREDIC */
-    band->s = saturate(band->sp + band->sz);
+static inline void block4(struct g722_band *band, int d)
+{
+    block4_bands(band, &d, 1);
 }
 /*- End of function --------------------------------------------------------*/
@@ -0,0 +1,89 @@
+/*
+ * g722_cpu.h - The ITU G.722 codec, CPU feature detection.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ */
+
+/*! \file */
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define G722_CPU_X86
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define G722_CPU_AVX
+#include <immintrin.h>
+#define G722_TARGET(x) __attribute__((target(x)))
+#elif defined(_MSC_VER)
+#define G722_CPU_AVX
+#include <immintrin.h>
+#include <intrin.h>
+#define G722_TARGET(x)
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define G722_CPU_SSE2_BASELINE
+#define G722_TARGET_SSE2
+#else
+#define G722_TARGET_SSE2 G722_TARGET("sse2")
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define G722_CPU_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(G722_CPU_X86)
+static inline int g722_cpu_has_sse2(void)
+{
+#if defined(G722_CPU_SSE2_BASELINE)
+    return 1;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("sse2");
+#else
+    return 0;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(_MSC_VER) && !defined(__clang__)
+/* Check a leaf 7 feature bit in EBX, and that the OS saves the given XCR0 state */
+static inline int g722_cpu_has_leaf7(int ebx_bit, unsigned int xcr0_mask)
+{
+    int regs[4];
+
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return 0;
+    __cpuid(regs, 1);
+    if ((regs[2] & (1 << 27)) == 0  ||  (_xgetbv(0) & xcr0_mask) != xcr0_mask)
+        return 0;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << ebx_bit)) != 0;
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+static inline int g722_cpu_has_avx2(void)
+{
+#if !defined(G722_CPU_AVX)
+    return 0;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return g722_cpu_has_leaf7(5, 0x06);
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline int g722_cpu_has_avx512f(void)
+{
+#if !defined(G722_CPU_AVX)
+    return 0;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx512f");
+#else
+    return g722_cpu_has_leaf7(16, 0xE6);
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+#endif
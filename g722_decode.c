@@ -33,16 +33,23 @@
 
 #include "g722_private.h"
 #include "g722_common.h"
+#include "g722_tables.h"
+#include "g722_g711.h"
 #include "g722.h"
 #include "g722_decoder.h"
 
-G722_DEC_CTX *g722_decoder_new(int rate, int options)
+static g722_decode_fn decode_select(const G722_DEC_CTX *s);
+
+/* The bytes a context takes, with room for the interpolator the options ask for */
+static size_t decoder_size(int options)
 {
-    G722_DEC_CTX *s;
+    return sizeof(G722_DEC_CTX) + ((options & G722_RESAMPLE_48000)  ?  sizeof(struct g722_decode_rs)  :  0);
+}
+/*- End of function --------------------------------------------------------*/
 
-    if ((s = (G722_DEC_CTX *) malloc(sizeof(*s))) == NULL)
-        return NULL;
-    memset(s, 0, sizeof(*s));
+static void decoder_setup(G722_DEC_CTX *s, int rate, int options)
+{
+    memset(s, 0, decoder_size(options));
     if (rate == 48000)
         s->bits_per_sample = 6;
     else if (rate == 56000)
@@ -55,12 +62,74 @@ G722_DEC_CTX *g722_decoder_new(int rate, int options)
         s->packed = TRUE;
     else
         s->packed = FALSE;
+    if ((options & G722_RESAMPLE_48000))
+        s->rs48k = TRUE;
     s->band[0].det = 32;
     s->band[1].det = 8;
+    s->qmf = g722_qmf_select();
+    s->decode = decode_select(s);
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_DEC_CTX *g722_decoder_new(int rate, int options)
+{
+    G722_DEC_CTX *s;
+
+    if ((s = (G722_DEC_CTX *) malloc(decoder_size(options))) == NULL)
+        return NULL;
+    decoder_setup(s, rate, options);
     return s;
 }
 /*- End of function --------------------------------------------------------*/
 
+size_t g722_decoder_state_size(void)
+{
+    return decoder_size(G722_RESAMPLE_48000);
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_DEC_CTX *g722_decoder_init(void *mem, int rate, int options)
+{
+    G722_DEC_CTX *s;
+
+    if (mem == NULL  ||  ((uintptr_t) mem & (G722_STATE_ALIGN - 1)) != 0)
+        return NULL;
+    s = (G722_DEC_CTX *) mem;
+    decoder_setup(s, rate, options);
+    return s;
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_DEC_CTX *g722_decoder_clone(const G722_DEC_CTX *s)
+{
+    G722_DEC_CTX *t;
+    size_t size;
+
+    size = decoder_size((s->rs48k)  ?  G722_RESAMPLE_48000  :  0);
+    if ((t = (G722_DEC_CTX *) malloc(size)) == NULL)
+        return NULL;
+    memcpy(t, s, size);
+    return t;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_decoder_state_equal(const G722_DEC_CTX *s1, const G722_DEC_CTX *s2)
+{
+    /* The loops and the QMF kernel follow from the modes, and the band
+       state has no padding to worry about */
+    return s1->itu_test_mode == s2->itu_test_mode
+        &&  s1->packed == s2->packed
+        &&  s1->eight_k == s2->eight_k
+        &&  s1->bits_per_sample == s2->bits_per_sample
+        &&  s1->in_buffer == s2->in_buffer
+        &&  s1->in_bits == s2->in_bits
+        &&  memcmp(s1->band, s2->band, sizeof(s1->band)) == 0
+        &&  memcmp(s1->x, s2->x, sizeof(s1->x)) == 0
+        &&  s1->rs48k == s2->rs48k
+        &&  (!s1->rs48k  ||  memcmp(s1->rs->hist, s2->rs->hist, sizeof(s1->rs->hist)) == 0);
+}
+/*- End of function --------------------------------------------------------*/
+
 int g722_decoder_destroy(G722_DEC_CTX *s)
 {
     free(s);
@@ -68,215 +137,563 @@ int g722_decoder_destroy(G722_DEC_CTX *s)
 }
 /*- End of function --------------------------------------------------------*/
 
-int g722_decode(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[])
+int g722_decoder_get_stats(const G722_DEC_CTX *s, struct g722_stats *stats)
 {
-    static const int wl[8] = {-60, -30, 58, 172, 334, 538, 1198, 3042 };
-    static const int rl42[16] = {0, 7, 6, 5, 4, 3, 2, 1, 7, 6, 5, 4, 3,  2, 1, 0 };
-    static const int ilb[32] =
-    {
-        2048, 2093, 2139, 2186, 2233, 2282, 2332,
-        2383, 2435, 2489, 2543, 2599, 2656, 2714,
-        2774, 2834, 2896, 2960, 3025, 3091, 3158,
-        3228, 3298, 3371, 3444, 3520, 3597, 3676,
-        3756, 3838, 3922, 4008
-    };
-    static const int wh[3] = {0, -214, 798};
-    static const int rh2[4] = {2, 1, 2, 1};
-    static const int qm2[4] = {-7408, -1616,  7408,   1616};
-    static const int qm4[16] = 
-    {
-              0, -20456, -12896,  -8968, 
-          -6288,  -4240,  -2584,  -1200,
-          20456,  12896,   8968,   6288,
-           4240,   2584,   1200,      0
-    };
-    static const int qm5[32] =
+#if defined(G722_ENABLE_STATS)
+    *stats = s->stats;
+    return 0;
+#else
+    (void) s;
+    memset(stats, 0, sizeof(*stats));
+    return -1;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(G722_ENABLE_STATS)
+/* Count a call, and collect the clips and limits it ran into */
+static void decoder_stats(G722_DEC_CTX *s, const int16_t amp[], int len)
+{
+    g722_stats_samples(&s->stats, amp, len);
+    g722_tally_collect(&s->stats);
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+
+static G722_ALWAYS_INLINE int decode_get(G722_DEC_CTX *s, const uint8_t g722_data[], int *j,
+  const int packed, const int bits_per_sample)
+{
+    int code;
+
+    if (packed)
     {
-           -280,   -280, -23352, -17560,
-         -14120, -11664,  -9752,  -8184,
-          -6864,  -5712,  -4696,  -3784,
-          -2960,  -2208,  -1520,   -880,
-          23352,  17560,  14120,  11664,
-           9752,   8184,   6864,   5712,
-           4696,   3784,   2960,   2208,
-           1520,    880,    280,   -280
-    };
-    static const int qm6[64] =
+        /* Unpack the code bits */
+        if (s->in_bits < bits_per_sample)
+        {
+            s->in_buffer |= (g722_data[(*j)++] << s->in_bits);
+            s->in_bits += 8;
+        }
+        code = s->in_buffer & ((1 << bits_per_sample) - 1);
+        s->in_buffer >>= bits_per_sample;
+        s->in_bits -= bits_per_sample;
+    }
+    else
     {
-           -136,   -136,   -136,   -136,
-         -24808, -21904, -19008, -16704,
-         -14984, -13512, -12280, -11192,
-         -10232,  -9360,  -8576,  -7856,
-          -7192,  -6576,  -6000,  -5456,
-          -4944,  -4464,  -4008,  -3576,
-          -3168,  -2776,  -2400,  -2032,
-          -1688,  -1360,  -1040,   -728,
-          24808,  21904,  19008,  16704,
-          14984,  13512,  12280,  11192,
-          10232,   9360,   8576,   7856,
-           7192,   6576,   6000,   5456,
-           4944,   4464,   4008,   3576,
-           3168,   2776,   2400,   2032,
-           1688,   1360,   1040,    728,
-            432,    136,   -432,   -136
-    };
-    static const int qmf_coeffs[12] =
+        code = g722_data[(*j)++];
+    }
+    return code;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Unpack up to G722_QMF_BLOCK codes from the bit stream, stopping where
+   the code at a time decode_get() loop would stop. Eight codes take exactly
+   bits_per_sample bytes, so they come out a group at a time from a 64 bit
+   word, and leave the pending bits carried between calls as they were. */
+static G722_ALWAYS_INLINE int decode_unpack(G722_DEC_CTX *s, const uint8_t g722_data[], int *jp, int len,
+  uint8_t codes[], const int bits_per_sample)
+{
+    const uint64_t mask = ((uint64_t) 1 << 8*bits_per_sample) - 1;
+    uint64_t acc;
+    int n;
+    int j;
+    int k;
+
+    n = 0;
+    j = *jp;
+    for (  ;  n + 8 <= G722_QMF_BLOCK  &&  j + 8 <= len;  n += 8)
     {
-           3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
-    };
+        acc = ((g722_load_le64(g722_data + j) & mask) << s->in_bits) | s->in_buffer;
+        for (k = 0;  k < 8;  k++)
+            codes[n + k] = (uint8_t) ((acc >> (k*bits_per_sample)) & ((1 << bits_per_sample) - 1));
+        s->in_buffer = (uint16_t) (acc >> 8*bits_per_sample);
+        j += bits_per_sample;
+    }
+    for (  ;  n < G722_QMF_BLOCK  &&  j < len;  n++)
+        codes[n] = (uint8_t) decode_get(s, g722_data, &j, TRUE, bits_per_sample);
+    *jp = j;
+    return n;
+}
+/*- End of function --------------------------------------------------------*/
 
+/* Run the ADPCM part of the decoder for one code on a pair of bands,
+   producing the low and high band reconstructed signals */
+static G722_ALWAYS_INLINE void decode_bands(struct g722_band band[], int code, int *rlowp, int *rhighp,
+  const int eight_k, const int bits_per_sample)
+{
     int dlowt;
     int rlow;
     int ihigh;
     int dhigh;
     int rhigh;
-    int xout1;
-    int xout2;
+    int d[2];
     int wd1;
     int wd2;
-    int wd3;
-    int code;
-    int outlen;
-    int i;
-    int j;
 
-    outlen = 0;
+    switch (bits_per_sample)
+    {
+    default:
+    case 8:
+        wd1 = code & 0x3F;
+        ihigh = (code >> 6) & 0x03;
+        wd2 = g722_tables.qm6[wd1];
+        wd1 >>= 2;
+        break;
+    case 7:
+        wd1 = code & 0x1F;
+        ihigh = (code >> 5) & 0x03;
+        wd2 = g722_tables.qm5[wd1];
+        wd1 >>= 1;
+        break;
+    case 6:
+        wd1 = code & 0x0F;
+        ihigh = (code >> 4) & 0x03;
+        wd2 = g722_tables.qm4[wd1];
+        break;
+    }
+    /* Block 5L, LOW BAND INVQBL */
+    wd2 = (band[0].det*wd2) >> 15;
+    /* Block 5L, RECONS */
+    rlow = band[0].s + wd2;
+    /* Block 6L, LIMIT */
+    if (rlow > 16383)
+    {
+        rlow = 16383;
+        G722_TALLY(signal_limits[0]);
+    }
+    else if (rlow < -16384)
+    {
+        rlow = -16384;
+        G722_TALLY(signal_limits[0]);
+    }
+
+    /* Block 2L, INVQAL */
+    wd2 = g722_tables.qm4[wd1];
+    dlowt = (band[0].det*wd2) >> 15;
+
+    /* Block 3L, LOGSCL and SCALEL */
+    g722_adapt_low(&band[0], wd1);
+
     rhigh = 0;
-    for (j = 0;  j < len;  )
+    if (eight_k)
     {
-        if (s->packed)
+        block4(&band[0], dlowt);
+    }
+    else
+    {
+        /* Block 2H, INVQAH */
+        wd2 = g722_tables.qm2[ihigh];
+        dhigh = (band[1].det*wd2) >> 15;
+        /* Block 5H, RECONS */
+        rhigh = dhigh + band[1].s;
+        /* Block 6H, LIMIT */
+        if (rhigh > 16383)
         {
-            /* Unpack the code bits */
-            if (s->in_bits < s->bits_per_sample)
-            {
-                s->in_buffer |= (g722_data[j++] << s->in_bits);
-                s->in_bits += 8;
-            }
-            code = s->in_buffer & ((1 << s->bits_per_sample) - 1);
-            s->in_buffer >>= s->bits_per_sample;
-            s->in_bits -= s->bits_per_sample;
+            rhigh = 16383;
+            G722_TALLY(signal_limits[1]);
         }
-        else
+        else if (rhigh < -16384)
         {
-            code = g722_data[j++];
+            rhigh = -16384;
+            G722_TALLY(signal_limits[1]);
         }
 
-        switch (s->bits_per_sample)
-        {
-        default:
-        case 8:
-            wd1 = code & 0x3F;
-            ihigh = (code >> 6) & 0x03;
-            wd2 = qm6[wd1];
-            wd1 >>= 2;
-            break;
-        case 7:
-            wd1 = code & 0x1F;
-            ihigh = (code >> 5) & 0x03;
-            wd2 = qm5[wd1];
-            wd1 >>= 1;
-            break;
-        case 6:
-            wd1 = code & 0x0F;
-            ihigh = (code >> 4) & 0x03;
-            wd2 = qm4[wd1];
-            break;
-        }
-        /* Block 5L, LOW BAND INVQBL */
-        wd2 = (s->band[0].det*wd2) >> 15;
-        /* Block 5L, RECONS */
-        rlow = s->band[0].s + wd2;
-        /* Block 6L, LIMIT */
-        if (rlow > 16383)
-            rlow = 16383;
-        else if (rlow < -16384)
-            rlow = -16384;
-
-        /* Block 2L, INVQAL */
-        wd2 = qm4[wd1];
-        dlowt = (s->band[0].det*wd2) >> 15;
-
-        /* Block 3L, LOGSCL */
-        wd2 = rl42[wd1];
-        wd1 = (s->band[0].nb*127) >> 7;
-        wd1 += wl[wd2];
-        if (wd1 < 0)
-            wd1 = 0;
-        else if (wd1 > 18432)
-            wd1 = 18432;
-        s->band[0].nb = wd1;
-            
-        /* Block 3L, SCALEL */
-        wd1 = (s->band[0].nb >> 6) & 31;
-        wd2 = 8 - (s->band[0].nb >> 11);
-        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-        s->band[0].det = wd3 << 2;
-
-        block4(&s->band[0], dlowt);
-        
-        if (!s->eight_k)
+        /* Block 3H, LOGSCH and SCALEH */
+        g722_adapt_high(&band[1], ihigh);
+
+        /* The high band never looks at the low band, so block 4 can do both at once */
+        d[0] = dlowt;
+        d[1] = dhigh;
+        block4_bands(band, d, 2);
+    }
+    *rlowp = rlow;
+    *rhighp = rhigh;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Run the ADPCM part of the decoder for one code */
+static G722_ALWAYS_INLINE void decode_adpcm(G722_DEC_CTX *s, int code, int *rlowp, int *rhighp,
+  const int eight_k, const int bits_per_sample)
+{
+    decode_bands(s->band, code, rlowp, rhighp, eight_k, bits_per_sample);
+    G722_STATS(g722_stats_nb(&s->stats, s->band, 1, eight_k));
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Get the next block of up to G722_QMF_BLOCK codes, unpacked if need be */
+static G722_ALWAYS_INLINE int decode_block(G722_DEC_CTX *s, const uint8_t g722_data[], int *jp, int len,
+  uint8_t codes[], const uint8_t **cp, const int packed, const int bits_per_sample)
+{
+    int n;
+
+    if (packed)
+    {
+        n = decode_unpack(s, g722_data, jp, len, codes, bits_per_sample);
+        *cp = codes;
+    }
+    else
+    {
+        n = len - *jp;
+        if (n > G722_QMF_BLOCK)
+            n = G722_QMF_BLOCK;
+        *cp = g722_data + *jp;
+        *jp += n;
+    }
+    return n;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* After a block ending in a run of one code, see if that code now leaves
+   the state as it is, and the QMF history is full of its output. If so,
+   every further repeat of the code will produce the same output, which is
+   cached for decode_idle_run(). */
+static G722_ALWAYS_INLINE void decode_idle_probe(G722_DEC_CTX *s, const uint8_t c[], int n,
+  const int eight_k, const int bits_per_sample)
+{
+    struct g722_band band[2];
+    int16_t xbuf[G722_QMF_HIST + 2];
+#if defined(G722_ENABLE_STATS)
+    struct g722_tally tally;
+#endif
+    int rlow;
+    int rhigh;
+    int k;
+
+    if (n < G722_IDLE_RUN)
+        return;
+    for (k = n - G722_IDLE_RUN;  k < n - 1;  k++)
+    {
+        if (c[k] != c[n - 1])
+            return;
+    }
+    /* These are only trials, so any clips and limits count for nothing */
+    memcpy(band, s->band, sizeof(band));
+    G722_STATS(tally = g722_tally);
+    decode_bands(band, c[n - 1], &rlow, &rhigh, eight_k, bits_per_sample);
+    G722_STATS(g722_tally = tally);
+    if (memcmp(band, s->band, sizeof(band)) != 0)
+        return;
+    if (eight_k)
+    {
+        s->idle_out[0] = (int16_t) (rlow << 1);
+    }
+    else
+    {
+        for (k = 0;  k < G722_QMF_HIST + 2;  k += 2)
         {
-            /* Block 2H, INVQAH */
-            wd2 = qm2[ihigh];
-            dhigh = (s->band[1].det*wd2) >> 15;
-            /* Block 5H, RECONS */
-            rhigh = dhigh + s->band[1].s;
-            /* Block 6H, LIMIT */
-            if (rhigh > 16383)
-                rhigh = 16383;
-            else if (rhigh < -16384)
-                rhigh = -16384;
-
-            /* Block 2H, INVQAH */
-            wd2 = rh2[ihigh];
-            wd1 = (s->band[1].nb*127) >> 7;
-            wd1 += wh[wd2];
-            if (wd1 < 0)
-                wd1 = 0;
-            else if (wd1 > 22528)
-                wd1 = 22528;
-            s->band[1].nb = wd1;
-            
-            /* Block 3H, SCALEH */
-            wd1 = (s->band[1].nb >> 6) & 31;
-            wd2 = 10 - (s->band[1].nb >> 11);
-            wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-            s->band[1].det = wd3 << 2;
-
-            block4(&s->band[1], dhigh);
+            xbuf[k] = (int16_t) (rlow + rhigh);
+            xbuf[k + 1] = (int16_t) (rlow - rhigh);
         }
+        if (memcmp(s->x, xbuf, sizeof(s->x)) != 0)
+            return;
+        G722_STATS(tally = g722_tally);
+        s->qmf(xbuf, 1, 11, &g722_qmf_rx_taps, s->idle_out);
+        G722_STATS(g722_tally = tally);
+    }
+    s->idle_code = c[n - 1];
+    s->idle = TRUE;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The number of codes at the start of a block that repeat the cached idle
+   code, and so need no decoding */
+static G722_ALWAYS_INLINE int decode_idle_run(const G722_DEC_CTX *s, const uint8_t c[], int n)
+{
+    int k;
 
-        if (s->itu_test_mode)
+    if (!s->idle)
+        return 0;
+    for (k = 0;  k < n  &&  c[k] == s->idle_code;  k++)
+        ;
+    return k;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The decoder without the receive QMF, for 8k samples/second output, or
+   the ITU test mode. The output is linear, or G.711 compressed as it is
+   written. */
+static G722_ALWAYS_INLINE int decode_narrow(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[],
+  uint8_t g711_data[], const int law, const int itu_test_mode, const int eight_k, const int packed,
+  const int bits_per_sample)
+{
+    /* Codes unpacked from the bit stream */
+    uint8_t codes[G722_QMF_BLOCK];
+    const uint8_t *c;
+    uint8_t idle;
+    int rlow;
+    int rhigh;
+    int outlen;
+    int n;
+    int i;
+    int j;
+    int k;
+
+    outlen = 0;
+    for (j = 0;  j < len;  )
+    {
+        n = decode_block(s, g722_data, &j, len, codes, &c, packed, bits_per_sample);
+        G722_STATS(g722_stats_codes(&s->stats, c, n));
+        k = 0;
+        if (!itu_test_mode)
         {
-            amp[outlen++] = (int16_t) (rlow << 1);
-            amp[outlen++] = (int16_t) (rhigh << 1);
+            k = decode_idle_run(s, c, n);
+            G722_STATS(s->stats.idle_codes += k);
+            G722_STATS(g722_stats_nb(&s->stats, s->band, k, eight_k));
+            if (law == G722_LAW_ULAW)
+            {
+                idle = g722_linear_to_ulaw(s->idle_out[0]);
+                memset(g711_data + outlen, idle, k);
+            }
+            else if (law == G722_LAW_ALAW)
+            {
+                idle = g722_linear_to_alaw(s->idle_out[0]);
+                memset(g711_data + outlen, idle, k);
+            }
+            else
+            {
+                for (i = 0;  i < k;  i++)
+                    amp[outlen + i] = s->idle_out[0];
+            }
+            outlen += k;
+            if (k == n)
+                continue;
+            s->idle = FALSE;
         }
-        else
+        for (  ;  k < n;  k++)
         {
-            if (s->eight_k)
+            decode_adpcm(s, c[k], &rlow, &rhigh, eight_k, bits_per_sample);
+            if (law == G722_LAW_ULAW)
             {
-                amp[outlen++] = (int16_t) (rlow << 1);
+                g711_data[outlen++] = g722_linear_to_ulaw(rlow << 1);
+            }
+            else if (law == G722_LAW_ALAW)
+            {
+                g711_data[outlen++] = g722_linear_to_alaw(rlow << 1);
             }
             else
             {
-                /* Apply the receive QMF */
-                for (i = 0;  i < 22;  i++)
-                    s->x[i] = s->x[i + 2];
-                s->x[22] = rlow + rhigh;
-                s->x[23] = rlow - rhigh;
-
-                xout1 = 0;
-                xout2 = 0;
-                for (i = 0;  i < 12;  i++)
-                {
-                    xout2 += s->x[2*i]*qmf_coeffs[i];
-                    xout1 += s->x[2*i + 1]*qmf_coeffs[11 - i];
-                }
-                amp[outlen++] = saturate(xout1 >> 11);
-                amp[outlen++] = saturate(xout2 >> 11);
+                amp[outlen++] = (int16_t) (rlow << 1);
+                if (itu_test_mode)
+                    amp[outlen++] = (int16_t) (rhigh << 1);
             }
         }
+        if (!itu_test_mode)
+            decode_idle_probe(s, c, n, eight_k, bits_per_sample);
+    }
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The whole decoder, for one combination of modes. With constant modes
+   this becomes a kernel without any per sample tests of them. */
+static G722_ALWAYS_INLINE int decode_kernel(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[],
+  const int itu_test_mode, const int eight_k, const int packed, const int bits_per_sample)
+{
+    /* The QMF history, followed by the new QMF input for a block of codes */
+    int16_t xbuf[G722_QMF_HIST + 2*G722_QMF_BLOCK];
+    /* Codes unpacked from the bit stream */
+    uint8_t codes[G722_QMF_BLOCK];
+    const uint8_t *c;
+    int rlow;
+    int rhigh;
+    int outlen;
+    int pairs;
+    int n;
+    int i;
+    int j;
+    int k;
+
+    if (itu_test_mode  ||  eight_k)
+    {
+        return decode_narrow(s, g722_data, len, amp, NULL, G722_LAW_LINEAR, itu_test_mode, eight_k, packed,
+          bits_per_sample);
+    }
+
+    outlen = 0;
+    for (j = 0;  j < len;  )
+    {
+        n = decode_block(s, g722_data, &j, len, codes, &c, packed, bits_per_sample);
+        G722_STATS(g722_stats_codes(&s->stats, c, n));
+
+        /* Repeats of a settled idle code just replay its output */
+        k = decode_idle_run(s, c, n);
+        G722_STATS(s->stats.idle_codes += k);
+        G722_STATS(g722_stats_nb(&s->stats, s->band, k, eight_k));
+        for (i = 0;  i < k;  i++)
+        {
+            amp[outlen++] = s->idle_out[0];
+            amp[outlen++] = s->idle_out[1];
+        }
+        if (k == n)
+            continue;
+        s->idle = FALSE;
+
+        /* Run the ADPCM for the rest of the block, straight into the QMF input */
+        for (pairs = 0;  k + pairs < n;  pairs++)
+        {
+            decode_adpcm(s, c[k + pairs], &rlow, &rhigh, eight_k, bits_per_sample);
+            xbuf[G722_QMF_HIST + 2*pairs] = (int16_t) (rlow + rhigh);
+            xbuf[G722_QMF_HIST + 2*pairs + 1] = (int16_t) (rlow - rhigh);
+        }
+
+        /* Apply the receive QMF to the whole block */
+        memcpy(xbuf, s->x, sizeof(s->x));
+        s->qmf(xbuf, pairs, 11, &g722_qmf_rx_taps, amp + outlen);
+        memcpy(s->x, xbuf + 2*pairs, sizeof(s->x));
+        outlen += 2*pairs;
+
+        decode_idle_probe(s, c, n, eight_k, bits_per_sample);
+    }
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The ITU test mode is only for conformance testing, so it makes do with
+   the modes tested at run time */
+static int decode_test(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[])
+{
+    return decode_kernel(s, g722_data, len, amp, TRUE, s->eight_k, s->packed, s->bits_per_sample);
+}
+/*- End of function --------------------------------------------------------*/
+
+#define DECODE_KERNEL(name, eight_k, packed, bits_per_sample) \
+static int name(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[]) \
+{ \
+    return decode_kernel(s, g722_data, len, amp, FALSE, eight_k, packed, bits_per_sample); \
+}
+
+DECODE_KERNEL(decode_64k, FALSE, FALSE, 8)
+DECODE_KERNEL(decode_56k, FALSE, FALSE, 7)
+DECODE_KERNEL(decode_56k_packed, FALSE, TRUE, 7)
+DECODE_KERNEL(decode_48k, FALSE, FALSE, 6)
+DECODE_KERNEL(decode_48k_packed, FALSE, TRUE, 6)
+DECODE_KERNEL(decode_64k_8k, TRUE, FALSE, 8)
+DECODE_KERNEL(decode_56k_8k, TRUE, FALSE, 7)
+DECODE_KERNEL(decode_56k_8k_packed, TRUE, TRUE, 7)
+DECODE_KERNEL(decode_48k_8k, TRUE, FALSE, 6)
+DECODE_KERNEL(decode_48k_8k_packed, TRUE, TRUE, 6)
+
+/* Indexed by eight_k, bits_per_sample - 6 and packed */
+static const g722_decode_fn decode_kernels[2][3][2] =
+{
+    {
+        {decode_48k, decode_48k_packed},
+        {decode_56k, decode_56k_packed},
+        {decode_64k, decode_64k}
+    },
+    {
+        {decode_48k_8k, decode_48k_8k_packed},
+        {decode_56k_8k, decode_56k_8k_packed},
+        {decode_64k_8k, decode_64k_8k}
+    }
+};
+
+#define DECODE_G711_KERNEL(name, law, packed, bits_per_sample) \
+static int name(G722_DEC_CTX *s, const uint8_t g722_data[], int len, uint8_t g711_data[]) \
+{ \
+    return decode_narrow(s, g722_data, len, NULL, g711_data, law, FALSE, TRUE, packed, bits_per_sample); \
+}
+
+DECODE_G711_KERNEL(decode_64k_ulaw, G722_LAW_ULAW, FALSE, 8)
+DECODE_G711_KERNEL(decode_56k_ulaw, G722_LAW_ULAW, FALSE, 7)
+DECODE_G711_KERNEL(decode_56k_ulaw_packed, G722_LAW_ULAW, TRUE, 7)
+DECODE_G711_KERNEL(decode_48k_ulaw, G722_LAW_ULAW, FALSE, 6)
+DECODE_G711_KERNEL(decode_48k_ulaw_packed, G722_LAW_ULAW, TRUE, 6)
+DECODE_G711_KERNEL(decode_64k_alaw, G722_LAW_ALAW, FALSE, 8)
+DECODE_G711_KERNEL(decode_56k_alaw, G722_LAW_ALAW, FALSE, 7)
+DECODE_G711_KERNEL(decode_56k_alaw_packed, G722_LAW_ALAW, TRUE, 7)
+DECODE_G711_KERNEL(decode_48k_alaw, G722_LAW_ALAW, FALSE, 6)
+DECODE_G711_KERNEL(decode_48k_alaw_packed, G722_LAW_ALAW, TRUE, 6)
+
+typedef int (*g722_decode_g711_fn)(G722_DEC_CTX *s, const uint8_t g722_data[], int len, uint8_t g711_data[]);
+
+/* Indexed by law - G722_LAW_ULAW, bits_per_sample - 6 and packed */
+static const g722_decode_g711_fn decode_g711_kernels[2][3][2] =
+{
+    {
+        {decode_48k_ulaw, decode_48k_ulaw_packed},
+        {decode_56k_ulaw, decode_56k_ulaw_packed},
+        {decode_64k_ulaw, decode_64k_ulaw}
+    },
+    {
+        {decode_48k_alaw, decode_48k_alaw_packed},
+        {decode_56k_alaw, decode_56k_alaw_packed},
+        {decode_64k_alaw, decode_64k_alaw}
+    }
+};
+
+static g722_decode_fn decode_select(const G722_DEC_CTX *s)
+{
+    if (s->itu_test_mode)
+        return decode_test;
+    return decode_kernels[s->eight_k][s->bits_per_sample - 6][s->packed];
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_decode(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[])
+{
+    int outlen;
+
+    G722_STATS(g722_tally_reset());
+    outlen = s->decode(s, g722_data, len, amp);
+    G722_STATS(decoder_stats(s, amp, outlen));
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_decode_ulaw(G722_DEC_CTX *s, const uint8_t g722_data[], int len, uint8_t g711_data[])
+{
+    int outlen;
+
+    if (!s->eight_k  ||  s->itu_test_mode)
+        return -1;
+    G722_STATS(g722_tally_reset());
+    outlen = decode_g711_kernels[0][s->bits_per_sample - 6][s->packed](s, g722_data, len, g711_data);
+    G722_STATS(decoder_stats(s, NULL, outlen));
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_decode_alaw(G722_DEC_CTX *s, const uint8_t g722_data[], int len, uint8_t g711_data[])
+{
+    int outlen;
+
+    if (!s->eight_k  ||  s->itu_test_mode)
+        return -1;
+    G722_STATS(g722_tally_reset());
+    outlen = decode_g711_kernels[1][s->bits_per_sample - 6][s->packed](s, g722_data, len, g711_data);
+    G722_STATS(decoder_stats(s, NULL, outlen));
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_decode_48khz(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[])
+{
+    /* Up to a QMF block of decoded output at a time */
+    int16_t xbuf[2*G722_QMF_BLOCK];
+    const struct g722_rs_filter *f;
+    int outlen;
+    int n;
+    int m;
+    int j;
+
+    if (s->itu_test_mode  ||  !s->rs48k)
+        return -1;
+    G722_STATS(g722_tally_reset());
+    f = (s->eight_k)  ?  &g722_rs_8k  :  &g722_rs_16k;
+    outlen = 0;
+    /* At most G722_QMF_BLOCK codes at a time, allowing for the bits of a
+       partial code left pending by the last call when packed */
+    for (j = 0;  j < len;  j += n)
+    {
+        n = len - j;
+        if (n > (G722_QMF_BLOCK - 1)*s->bits_per_sample/8)
+            n = (G722_QMF_BLOCK - 1)*s->bits_per_sample/8;
+        m = s->decode(s, g722_data + j, n, xbuf);
+        g722_rs_interpolate(f, s->rs->hist, xbuf, m, amp + outlen);
+        outlen += f->ratio*m;
     }
+    G722_STATS(decoder_stats(s, amp, outlen));
     return outlen;
 }
 /*- End of function --------------------------------------------------------*/
@@ -39,6 +39,67 @@ G722_DEC_CTX *g722_decoder_new(int rate, int options);
 int g722_decoder_destroy(G722_DEC_CTX *s);
 int g722_decode(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[]);
 
+/*! \return The number of bytes of memory a decoder context occupies, with
+            any options. One without G722_RESAMPLE_48000 needs less, but
+            this much will always do. */
+size_t g722_decoder_state_size(void);
+/*! Set up a decoder context in memory provided by the caller, in place of
+    g722_decoder_new(). The context needs no g722_decoder_destroy(), the
+    caller just reuses or frees the memory when done with it.
+    \param mem At least g722_decoder_state_size() bytes, aligned to
+           G722_STATE_ALIGN bytes.
+    \param rate The bit rate, as for g722_decoder_new().
+    \param options The options, as for g722_decoder_new().
+    \return The context, at mem, or NULL if mem is NULL or misaligned. */
+G722_DEC_CTX *g722_decoder_init(void *mem, int rate, int options);
+/*! Make a copy of a decoder context, which then decodes exactly as the
+    original would from here on. A context set up with g722_decoder_init()
+    can equally be copied, as g722_decoder_state_size() bytes, to other
+    suitably aligned memory.
+    \param s The context to copy.
+    \return The new context, to be freed with g722_decoder_destroy(), or
+            NULL if out of memory. */
+G722_DEC_CTX *g722_decoder_clone(const G722_DEC_CTX *s);
+/*! Check if two decoder contexts are in the same state, so that they will
+    turn the same input into the same output from here on. Contexts that
+    are fed the same input converge, after which all but one may be
+    dropped, and the survivor cloned again when the inputs diverge.
+    \param s1 One context.
+    \param s2 The other context.
+    \return Non-zero if the states are the same, zero if not. */
+int g722_decoder_state_equal(const G722_DEC_CTX *s1, const G722_DEC_CTX *s2);
+/*! Decode G.722 straight to 8k samples/second G.711 audio, compressing
+    each sample as it is decoded rather than through a linear buffer. The
+    output is g722_decode()'s, compressed to mu-law or A-law.
+    \param s A decoder context set up with G722_SAMPLE_RATE_8000, and not
+           in the ITU test mode.
+    \param g722_data The G.722 input.
+    \param len The number of G.722 bytes.
+    \param g711_data The mu-law or A-law output.
+    \return The number of samples, or -1 if the context is not an 8k one. */
+int g722_decode_ulaw(G722_DEC_CTX *s, const uint8_t g722_data[], int len, uint8_t g711_data[]);
+int g722_decode_alaw(G722_DEC_CTX *s, const uint8_t g722_data[], int len, uint8_t g711_data[]);
+/*! Decode G.722 to 48k samples/second linear audio, interpolating the
+    16k (or with G722_SAMPLE_RATE_8000 the 8k) samples/second output up on
+    the way out. Every code gives 6 samples at 48k samples/second.
+    \param s A decoder context set up with G722_RESAMPLE_48000, and not
+           in the ITU test mode.
+    \param g722_data The G.722 input.
+    \param len The number of G.722 bytes.
+    \param amp The 48k samples/second audio.
+    \return The number of samples, or -1 if the context is not set up for
+            48k samples/second, or is in the ITU test mode. */
+int g722_decode_48khz(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[]);
+/*! Read the counters of a decoder context, which show how it has been
+    running, such as how often it clipped and which fast paths it took.
+    They are only kept when the library is built with G722_ENABLE_STATS,
+    and a clone starts with a copy of them.
+    \param s The context.
+    \param stats Set to the counters.
+    \return 0, or -1 if the library keeps no counters, in which case stats
+            is zeroed. */
+int g722_decoder_get_stats(const G722_DEC_CTX *s, struct g722_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,16 +34,23 @@
 
 #include "g722_private.h"
 #include "g722_common.h"
+#include "g722_tables.h"
+#include "g722_quantl.h"
+#include "g722_g711.h"
 #include "g722_encoder.h"
 
-G722_ENC_CTX *
-g722_encoder_new(int rate, int options)
+static g722_encode_fn encode_select(const G722_ENC_CTX *s);
+
+/* The bytes a context takes, with room for the decimator the options ask for */
+static size_t encoder_size(int options)
 {
-    G722_ENC_CTX *s;
+    return sizeof(G722_ENC_CTX) + ((options & G722_RESAMPLE_48000)  ?  sizeof(struct g722_encode_rs)  :  0);
+}
+/*- End of function --------------------------------------------------------*/
 
-    if ((s = (G722_ENC_CTX *) malloc(sizeof(*s))) == NULL)
-        return NULL;
-    memset(s, 0, sizeof(*s));
+static void encoder_setup(G722_ENC_CTX *s, int rate, int options)
+{
+    memset(s, 0, encoder_size(options));
     if (rate == 48000)
         s->bits_per_sample = 6;
     else if (rate == 56000)
@@ -56,12 +63,79 @@ g722_encoder_new(int rate, int options)
         s->packed = TRUE;
     else
         s->packed = FALSE;
+    if ((options & G722_RESAMPLE_48000))
+        s->rs48k = TRUE;
     s->band[0].det = 32;
     s->band[1].det = 8;
+    s->qmf = g722_qmf_select();
+    s->encode = encode_select(s);
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_ENC_CTX *
+g722_encoder_new(int rate, int options)
+{
+    G722_ENC_CTX *s;
+
+    if ((s = (G722_ENC_CTX *) malloc(encoder_size(options))) == NULL)
+        return NULL;
+    encoder_setup(s, rate, options);
+    return s;
+}
+/*- End of function --------------------------------------------------------*/
+
+size_t g722_encoder_state_size(void)
+{
+    return encoder_size(G722_RESAMPLE_48000);
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_ENC_CTX *g722_encoder_init(void *mem, int rate, int options)
+{
+    G722_ENC_CTX *s;
+
+    if (mem == NULL  ||  ((uintptr_t) mem & (G722_STATE_ALIGN - 1)) != 0)
+        return NULL;
+    s = (G722_ENC_CTX *) mem;
+    encoder_setup(s, rate, options);
     return s;
 }
 /*- End of function --------------------------------------------------------*/
 
+G722_ENC_CTX *g722_encoder_clone(const G722_ENC_CTX *s)
+{
+    G722_ENC_CTX *t;
+    size_t size;
+
+    size = encoder_size((s->rs48k)  ?  G722_RESAMPLE_48000  :  0);
+    if ((t = (G722_ENC_CTX *) malloc(size)) == NULL)
+        return NULL;
+    memcpy(t, s, size);
+    return t;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encoder_state_equal(const G722_ENC_CTX *s1, const G722_ENC_CTX *s2)
+{
+    /* The loops and the QMF kernel follow from the modes, and the band
+       state has no padding to worry about */
+    return s1->itu_test_mode == s2->itu_test_mode
+        &&  s1->packed == s2->packed
+        &&  s1->eight_k == s2->eight_k
+        &&  s1->bits_per_sample == s2->bits_per_sample
+        &&  s1->out_buffer == s2->out_buffer
+        &&  s1->out_bits == s2->out_bits
+        &&  memcmp(s1->band, s2->band, sizeof(s1->band)) == 0
+        &&  memcmp(s1->x, s2->x, sizeof(s1->x)) == 0
+        &&  s1->rs48k == s2->rs48k
+        &&  (!s1->rs48k
+             ||  (memcmp(s1->rs->hist, s2->rs->hist, sizeof(s1->rs->hist)) == 0
+                  &&  s1->rs->phase == s2->rs->phase
+                  &&  s1->rs->pending == s2->rs->pending
+                  &&  (!s1->rs->pending  ||  s1->rs->odd == s2->rs->odd)));
+}
+/*- End of function --------------------------------------------------------*/
+
 int g722_encoder_destroy(G722_ENC_CTX *s)
 {
     free(s);
@@ -69,218 +143,468 @@ int g722_encoder_destroy(G722_ENC_CTX *s)
 }
 /*- End of function --------------------------------------------------------*/
 
-int g722_encode(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[])
+int g722_encoder_get_stats(const G722_ENC_CTX *s, struct g722_stats *stats)
 {
-    static const int q6[32] =
-    {
-           0,   35,   72,  110,  150,  190,  233,  276,
-         323,  370,  422,  473,  530,  587,  650,  714,
-         786,  858,  940, 1023, 1121, 1219, 1339, 1458,
-        1612, 1765, 1980, 2195, 2557, 2919,    0,    0
-    };
-    static const int iln[32] =
-    {
-         0, 63, 62, 31, 30, 29, 28, 27,
-        26, 25, 24, 23, 22, 21, 20, 19,
-        18, 17, 16, 15, 14, 13, 12, 11,
-        10,  9,  8,  7,  6,  5,  4,  0
-    };
-    static const int ilp[32] =
-    {
-         0, 61, 60, 59, 58, 57, 56, 55,
-        54, 53, 52, 51, 50, 49, 48, 47,
-        46, 45, 44, 43, 42, 41, 40, 39,
-        38, 37, 36, 35, 34, 33, 32,  0
-    };
-    static const int wl[8] =
-    {
-        -60, -30, 58, 172, 334, 538, 1198, 3042
-    };
-    static const int rl42[16] =
-    {
-        0, 7, 6, 5, 4, 3, 2, 1, 7, 6, 5, 4, 3, 2, 1, 0
-    };
-    static const int ilb[32] =
-    {
-        2048, 2093, 2139, 2186, 2233, 2282, 2332,
-        2383, 2435, 2489, 2543, 2599, 2656, 2714,
-        2774, 2834, 2896, 2960, 3025, 3091, 3158,
-        3228, 3298, 3371, 3444, 3520, 3597, 3676,
-        3756, 3838, 3922, 4008
-    };
-    static const int qm4[16] =
-    {
-             0, -20456, -12896, -8968,
-         -6288,  -4240,  -2584, -1200,
-         20456,  12896,   8968,  6288,
-          4240,   2584,   1200,     0
-    };
-    static const int qm2[4] =
-    {
-        -7408,  -1616,   7408,   1616
-    };
-    static const int qmf_coeffs[12] =
-    {
-           3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
-    };
-    static const int ihn[3] = {0, 1, 0};
-    static const int ihp[3] = {0, 3, 2};
-    static const int wh[3] = {0, -214, 798};
-    static const int rh2[4] = {2, 1, 2, 1};
+#if defined(G722_ENABLE_STATS)
+    *stats = s->stats;
+    return 0;
+#else
+    (void) s;
+    memset(stats, 0, sizeof(*stats));
+    return -1;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
 
+#if defined(G722_ENABLE_STATS)
+/* Count a call, and collect the clips and limits it ran into */
+static void encoder_stats(G722_ENC_CTX *s, const int16_t amp[], int len)
+{
+    g722_stats_samples(&s->stats, amp, len);
+    g722_tally_collect(&s->stats);
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+
+/* Run the low band ADPCM blocks 1L to 3L for one sample, and return the
+   low band code */
+static G722_ALWAYS_INLINE int encode_low(G722_ENC_CTX *s, int xlow, int *dlowp)
+{
+    int el;
+    int wd;
+    int ril;
+    int wd2;
+    int i;
+    int ilow;
+
+    /* Block 1L, SUBTRA */
+    el = saturate(xlow - s->band[0].s);
+
+    /* Block 1L, QUANTL */
+    wd = (el >= 0)  ?  el  :  -(el + 1);
+    i = g722_quantl_index(wd, s->band[0].det);
+    ilow = (el < 0)  ?  g722_tables.iln[i]  :  g722_tables.ilp[i];
+
+    /* Block 2L, INVQAL */
+    ril = ilow >> 2;
+    wd2 = g722_tables.qm4[ril];
+    *dlowp = (s->band[0].det*wd2) >> 15;
+
+    /* Block 3L, LOGSCL and SCALEL */
+    g722_adapt_low(&s->band[0], ril);
+    return ilow;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Run the ADPCM part of the encoder for one sample pair, and return the code */
+static G722_ALWAYS_INLINE int encode_adpcm(G722_ENC_CTX *s, int xlow, int xhigh,
+  const int eight_k, const int bits_per_sample)
+{
     int dlow;
     int dhigh;
-    int el;
+    int d[2];
     int wd;
     int wd1;
-    int ril;
     int wd2;
-    int il4;
-    int ih2;
-    int wd3;
     int eh;
     int mih;
-    int i;
-    int j;
-    /* Low and high band PCM from the QMF */
-    int xlow;
-    int xhigh;
-    int g722_bytes;
-    /* Even and odd tap accumulators */
-    int sumeven;
-    int sumodd;
     int ihigh;
     int ilow;
+
+    ilow = encode_low(s, xlow, &dlow);
+
+    if (eight_k)
+    {
+        block4(&s->band[0], dlow);
+        G722_STATS(g722_stats_nb(&s->stats, s->band, 1, TRUE));
+        /* Just leave the high bits as zero */
+        return (0xC0 | ilow) >> (8 - bits_per_sample);
+    }
+
+    /* Block 1H, SUBTRA */
+    eh = saturate(xhigh - s->band[1].s);
+
+    /* Block 1H, QUANTH */
+    wd = (eh >= 0)  ?  eh  :  -(eh + 1);
+    wd1 = (564*s->band[1].det) >> 12;
+    mih = (wd >= wd1)  ?  2  :  1;
+    ihigh = (eh < 0)  ?  g722_tables.ihn[mih]  :  g722_tables.ihp[mih];
+
+    /* Block 2H, INVQAH */
+    wd2 = g722_tables.qm2[ihigh];
+    dhigh = (s->band[1].det*wd2) >> 15;
+
+    /* Block 3H, LOGSCH and SCALEH */
+    g722_adapt_high(&s->band[1], ihigh);
+
+    /* The high band never looks at the low band, so block 4 can do both at once */
+    d[0] = dlow;
+    d[1] = dhigh;
+    block4_bands(s->band, d, 2);
+    G722_STATS(g722_stats_nb(&s->stats, s->band, 1, FALSE));
+    return ((ihigh << 6) | ilow) >> (8 - bits_per_sample);
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Run the ADPCM part of the encoder for a sample pair of digital silence,
+   with nothing left in the QMF history to ring. The low band never settles
+   on silence, as its smallest quantiser step is not zero, but the high
+   band does, and after that it is only the low band that needs running. */
+static G722_ALWAYS_INLINE int encode_adpcm_silent(G722_ENC_CTX *s, const int bits_per_sample)
+{
+    struct g722_band high;
+    int dlow;
+    int ilow;
     int code;
 
-    g722_bytes = 0;
-    xhigh = 0;
-    for (j = 0;  j < len;  )
+    if (s->high_idle)
+    {
+        ilow = encode_low(s, 0, &dlow);
+        block4(&s->band[0], dlow);
+        G722_STATS(s->stats.idle_codes++);
+        G722_STATS(g722_stats_nb(&s->stats, s->band, 1, FALSE));
+        return ((s->idle_ihigh << 6) | ilow) >> (8 - bits_per_sample);
+    }
+    high = s->band[1];
+    code = encode_adpcm(s, 0, 0, FALSE, bits_per_sample);
+    /* The high band depends on nothing but its own state and input, so a
+       state that silence leaves unchanged stays that way */
+    if (memcmp(&high, &s->band[1], sizeof(high)) == 0)
+    {
+        s->high_idle = TRUE;
+        s->idle_ihigh = (uint8_t) (code >> (bits_per_sample - 2));
+    }
+    return code;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* TRUE if a block of samples is all digital silence */
+static G722_ALWAYS_INLINE int encode_silent(const int16_t amp[], int len)
+{
+    int16_t any;
+    int i;
+
+    any = 0;
+    for (i = 0;  i < len;  i++)
+        any |= amp[i];
+    return any == 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Pack a run of codes onto the end of the bit stream. Eight codes make
+   exactly bits_per_sample bytes, so they go in a group at a time through a
+   64 bit word, and the pending bits carried between calls are unchanged by
+   a group. Whole words may be stored up to g722_end, the number of bytes the
+   whole call produces, as the excess is overwritten later in the call. */
+static G722_ALWAYS_INLINE int encode_pack(G722_ENC_CTX *s, const uint8_t codes[], int n, uint8_t g722_data[],
+  int g722_bytes, int g722_end, const int bits_per_sample)
+{
+    uint64_t group;
+    uint64_t acc;
+    int bits;
+    int i;
+    int k;
+
+    acc = s->out_buffer;
+    bits = s->out_bits;
+    for (i = 0;  i + 8 <= n;  i += 8)
     {
-        if (s->itu_test_mode)
+        group = 0;
+        for (k = 0;  k < 8;  k++)
+            group |= (uint64_t) codes[i + k] << (k*bits_per_sample);
+        acc |= group << bits;
+        if (g722_bytes + 8 <= g722_end)
         {
-            xlow =
-            xhigh = amp[j++] >> 1;
+            g722_store_le64(g722_data + g722_bytes, acc);
         }
         else
         {
-            if (s->eight_k)
-            {
-                xlow = amp[j++] >> 1;
-            }
-            else
-            {
-                /* Apply the transmit QMF */
-                /* Shuffle the buffer down */
-                for (i = 0;  i < 22;  i++)
-                    s->x[i] = s->x[i + 2];
-                s->x[22] = amp[j++];
-                s->x[23] = amp[j++];
-    
-                /* Discard every other QMF output */
-                sumeven = 0;
-                sumodd = 0;
-                for (i = 0;  i < 12;  i++)
-                {
-                    sumodd += s->x[2*i]*qmf_coeffs[i];
-                    sumeven += s->x[2*i + 1]*qmf_coeffs[11 - i];
-                }
-                xlow = (sumeven + sumodd) >> 14;
-                xhigh = (sumeven - sumodd) >> 14;
-            }
+            for (k = 0;  k < bits_per_sample;  k++)
+                g722_data[g722_bytes + k] = (uint8_t) (acc >> 8*k);
+        }
+        g722_bytes += bits_per_sample;
+        acc >>= 8*bits_per_sample;
+    }
+    for (  ;  i < n;  i++)
+    {
+        acc |= (uint64_t) codes[i] << bits;
+        bits += bits_per_sample;
+        if (bits >= 8)
+        {
+            g722_data[g722_bytes++] = (uint8_t) (acc & 0xFF);
+            bits -= 8;
+            acc >>= 8;
         }
-        /* Block 1L, SUBTRA */
-        el = saturate(xlow - s->band[0].s);
+    }
+    s->out_buffer = (uint16_t) acc;
+    s->out_bits = (uint8_t) bits;
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
 
-        /* Block 1L, QUANTL */
-        wd = (el >= 0)  ?  el  :  -(el + 1);
+/* The number of whole bytes the packed codes of a call come to, with the
+   bits already pending */
+static G722_ALWAYS_INLINE int encode_end(const G722_ENC_CTX *s, int ncodes, const int bits_per_sample)
+{
+    return (int) (((int64_t) ncodes*bits_per_sample + s->out_bits) >> 3);
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The encoder without the transmit QMF, for 8k samples/second input, or
+   the ITU test mode. The input is linear, or G.711 expanded as it is read. */
+static G722_ALWAYS_INLINE int encode_narrow(G722_ENC_CTX *s, const int16_t amp[], const uint8_t g711_data[], int len,
+  uint8_t g722_data[], const int law, const int eight_k, const int packed, const int bits_per_sample)
+{
+    /* Codes waiting to be packed */
+    uint8_t codes[G722_QMF_BLOCK];
+    uint8_t *c;
+    int g722_bytes;
+    int g722_end;
+    int xlow;
+    int n;
+    int j;
+    int k;
 
-        for (i = 1;  i < 30;  i++)
+    g722_bytes = 0;
+    g722_end = (packed)  ?  encode_end(s, len, bits_per_sample)  :  0;
+    for (j = 0;  j < len;  j += n)
+    {
+        n = len - j;
+        if (n > G722_QMF_BLOCK)
+            n = G722_QMF_BLOCK;
+        c = (packed)  ?  codes  :  g722_data + g722_bytes;
+        for (k = 0;  k < n;  k++)
         {
-            wd1 = (q6[i]*s->band[0].det) >> 12;
-            if (wd < wd1)
-                break;
+            if (law == G722_LAW_ULAW)
+                xlow = g722_ulaw_to_linear(g711_data[j + k]);
+            else if (law == G722_LAW_ALAW)
+                xlow = g722_alaw_to_linear(g711_data[j + k]);
+            else
+                xlow = amp[j + k];
+            c[k] = (uint8_t) encode_adpcm(s, xlow >> 1, xlow >> 1, eight_k, bits_per_sample);
         }
-        ilow = (el < 0)  ?  iln[i]  :  ilp[i];
-
-        /* Block 2L, INVQAL */
-        ril = ilow >> 2;
-        wd2 = qm4[ril];
-        dlow = (s->band[0].det*wd2) >> 15;
-
-        /* Block 3L, LOGSCL */
-        il4 = rl42[ril];
-        wd = (s->band[0].nb*127) >> 7;
-        s->band[0].nb = wd + wl[il4];
-        if (s->band[0].nb < 0)
-            s->band[0].nb = 0;
-        else if (s->band[0].nb > 18432)
-            s->band[0].nb = 18432;
-
-        /* Block 3L, SCALEL */
-        wd1 = (s->band[0].nb >> 6) & 31;
-        wd2 = 8 - (s->band[0].nb >> 11);
-        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-        s->band[0].det = wd3 << 2;
+        G722_STATS(g722_stats_codes(&s->stats, c, n));
+        if (packed)
+            g722_bytes = encode_pack(s, codes, n, g722_data, g722_bytes, g722_end, bits_per_sample);
+        else
+            g722_bytes += n;
+    }
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
 
-        block4(&s->band[0], dlow);
-        
-        if (s->eight_k)
+/* The whole encoder, for one combination of modes. With constant modes
+   this becomes a kernel without any per sample tests of them. */
+static G722_ALWAYS_INLINE int encode_kernel(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[],
+  const int itu_test_mode, const int eight_k, const int packed, const int bits_per_sample)
+{
+    /* Low and high band PCM from the QMF, for a block of sample pairs */
+    int16_t xband[2*G722_QMF_BLOCK];
+    int16_t xbuf[G722_QMF_HIST + 2*G722_QMF_BLOCK];
+    /* Codes waiting to be packed */
+    uint8_t codes[G722_QMF_BLOCK];
+    uint8_t *c;
+    int g722_bytes;
+    int g722_end;
+    int pairs;
+    int j;
+    int k;
+
+    if (itu_test_mode  ||  eight_k)
+        return encode_narrow(s, amp, NULL, len, g722_data, G722_LAW_LINEAR, eight_k, packed, bits_per_sample);
+
+    g722_bytes = 0;
+    g722_end = (packed)  ?  encode_end(s, len/2, bits_per_sample)  :  0;
+    for (j = 0;  j + 2 <= len;  j += 2*pairs)
+    {
+        pairs = (len - j)/2;
+        if (pairs > G722_QMF_BLOCK)
+            pairs = G722_QMF_BLOCK;
+
+        c = (packed)  ?  codes  :  g722_data + g722_bytes;
+        if (encode_silent(amp + j, 2*pairs)  &&  encode_silent(s->x, G722_QMF_HIST))
         {
-            /* Just leave the high bits as zero */
-            code = (0xC0 | ilow) >> (8 - s->bits_per_sample);
+            /* The QMF would only turn silence into silence */
+            for (k = 0;  k < pairs;  k++)
+                c[k] = (uint8_t) encode_adpcm_silent(s, bits_per_sample);
+            G722_STATS(s->stats.silent_codes += pairs);
         }
         else
         {
-            /* Block 1H, SUBTRA */
-            eh = saturate(xhigh - s->band[1].s);
-
-            /* Block 1H, QUANTH */
-            wd = (eh >= 0)  ?  eh  :  -(eh + 1);
-            wd1 = (564*s->band[1].det) >> 12;
-            mih = (wd >= wd1)  ?  2  :  1;
-            ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
-
-            /* Block 2H, INVQAH */
-            wd2 = qm2[ihigh];
-            dhigh = (s->band[1].det*wd2) >> 15;
-
-            /* Block 3H, LOGSCH */
-            ih2 = rh2[ihigh];
-            wd = (s->band[1].nb*127) >> 7;
-            s->band[1].nb = wd + wh[ih2];
-            if (s->band[1].nb < 0)
-                s->band[1].nb = 0;
-            else if (s->band[1].nb > 22528)
-                s->band[1].nb = 22528;
-
-            /* Block 3H, SCALEH */
-            wd1 = (s->band[1].nb >> 6) & 31;
-            wd2 = 10 - (s->band[1].nb >> 11);
-            wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-            s->band[1].det = wd3 << 2;
-
-            block4(&s->band[1], dhigh);
-            code = ((ihigh << 6) | ilow) >> (8 - s->bits_per_sample);
-        }
+            /* Apply the transmit QMF to the whole block, the history followed
+               by the new samples making one contiguous signal */
+            memcpy(xbuf, s->x, sizeof(s->x));
+            memcpy(xbuf + G722_QMF_HIST, amp + j, 2*pairs*sizeof(amp[0]));
+            s->qmf(xbuf, pairs, 14, &g722_qmf_tx_taps, xband);
+            memcpy(s->x, xbuf + 2*pairs, sizeof(s->x));
 
-        if (s->packed)
-        {
-            /* Pack the code bits */
-            s->out_buffer |= (code << s->out_bits);
-            s->out_bits += s->bits_per_sample;
-            if (s->out_bits >= 8)
-            {
-                g722_data[g722_bytes++] = (uint8_t) (s->out_buffer & 0xFF);
-                s->out_bits -= 8;
-                s->out_buffer >>= 8;
-            }
+            for (k = 0;  k < pairs;  k++)
+                c[k] = (uint8_t) encode_adpcm(s, xband[2*k], xband[2*k + 1], eight_k, bits_per_sample);
+            s->high_idle = FALSE;
         }
+        G722_STATS(g722_stats_codes(&s->stats, c, pairs));
+        if (packed)
+            g722_bytes = encode_pack(s, codes, pairs, g722_data, g722_bytes, g722_end, bits_per_sample);
         else
+            g722_bytes += pairs;
+    }
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The ITU test mode is only for conformance testing, so it makes do with
+   the modes tested at run time */
+static int encode_test(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[])
+{
+    return encode_kernel(s, amp, len, g722_data, TRUE, s->eight_k, s->packed, s->bits_per_sample);
+}
+/*- End of function --------------------------------------------------------*/
+
+#define ENCODE_KERNEL(name, eight_k, packed, bits_per_sample) \
+static int name(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[]) \
+{ \
+    return encode_kernel(s, amp, len, g722_data, FALSE, eight_k, packed, bits_per_sample); \
+}
+
+ENCODE_KERNEL(encode_64k, FALSE, FALSE, 8)
+ENCODE_KERNEL(encode_56k, FALSE, FALSE, 7)
+ENCODE_KERNEL(encode_56k_packed, FALSE, TRUE, 7)
+ENCODE_KERNEL(encode_48k, FALSE, FALSE, 6)
+ENCODE_KERNEL(encode_48k_packed, FALSE, TRUE, 6)
+ENCODE_KERNEL(encode_64k_8k, TRUE, FALSE, 8)
+ENCODE_KERNEL(encode_56k_8k, TRUE, FALSE, 7)
+ENCODE_KERNEL(encode_56k_8k_packed, TRUE, TRUE, 7)
+ENCODE_KERNEL(encode_48k_8k, TRUE, FALSE, 6)
+ENCODE_KERNEL(encode_48k_8k_packed, TRUE, TRUE, 6)
+
+/* Indexed by eight_k, bits_per_sample - 6 and packed */
+static const g722_encode_fn encode_kernels[2][3][2] =
+{
+    {
+        {encode_48k, encode_48k_packed},
+        {encode_56k, encode_56k_packed},
+        {encode_64k, encode_64k}
+    },
+    {
+        {encode_48k_8k, encode_48k_8k_packed},
+        {encode_56k_8k, encode_56k_8k_packed},
+        {encode_64k_8k, encode_64k_8k}
+    }
+};
+
+#define ENCODE_G711_KERNEL(name, law, packed, bits_per_sample) \
+static int name(G722_ENC_CTX *s, const uint8_t g711_data[], int len, uint8_t g722_data[]) \
+{ \
+    return encode_narrow(s, NULL, g711_data, len, g722_data, law, TRUE, packed, bits_per_sample); \
+}
+
+ENCODE_G711_KERNEL(encode_64k_ulaw, G722_LAW_ULAW, FALSE, 8)
+ENCODE_G711_KERNEL(encode_56k_ulaw, G722_LAW_ULAW, FALSE, 7)
+ENCODE_G711_KERNEL(encode_56k_ulaw_packed, G722_LAW_ULAW, TRUE, 7)
+ENCODE_G711_KERNEL(encode_48k_ulaw, G722_LAW_ULAW, FALSE, 6)
+ENCODE_G711_KERNEL(encode_48k_ulaw_packed, G722_LAW_ULAW, TRUE, 6)
+ENCODE_G711_KERNEL(encode_64k_alaw, G722_LAW_ALAW, FALSE, 8)
+ENCODE_G711_KERNEL(encode_56k_alaw, G722_LAW_ALAW, FALSE, 7)
+ENCODE_G711_KERNEL(encode_56k_alaw_packed, G722_LAW_ALAW, TRUE, 7)
+ENCODE_G711_KERNEL(encode_48k_alaw, G722_LAW_ALAW, FALSE, 6)
+ENCODE_G711_KERNEL(encode_48k_alaw_packed, G722_LAW_ALAW, TRUE, 6)
+
+typedef int (*g722_encode_g711_fn)(G722_ENC_CTX *s, const uint8_t g711_data[], int len, uint8_t g722_data[]);
+
+/* Indexed by law - G722_LAW_ULAW, bits_per_sample - 6 and packed */
+static const g722_encode_g711_fn encode_g711_kernels[2][3][2] =
+{
+    {
+        {encode_48k_ulaw, encode_48k_ulaw_packed},
+        {encode_56k_ulaw, encode_56k_ulaw_packed},
+        {encode_64k_ulaw, encode_64k_ulaw}
+    },
+    {
+        {encode_48k_alaw, encode_48k_alaw_packed},
+        {encode_56k_alaw, encode_56k_alaw_packed},
+        {encode_64k_alaw, encode_64k_alaw}
+    }
+};
+
+static g722_encode_fn encode_select(const G722_ENC_CTX *s)
+{
+    if (s->itu_test_mode)
+        return encode_test;
+    return encode_kernels[s->eight_k][s->bits_per_sample - 6][s->packed];
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[])
+{
+    int g722_bytes;
+
+    G722_STATS(g722_tally_reset());
+    g722_bytes = s->encode(s, amp, len, g722_data);
+    G722_STATS(encoder_stats(s, amp, len));
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode_ulaw(G722_ENC_CTX *s, const uint8_t g711_data[], int len, uint8_t g722_data[])
+{
+    int g722_bytes;
+
+    if (!s->eight_k  ||  s->itu_test_mode)
+        return -1;
+    G722_STATS(g722_tally_reset());
+    g722_bytes = encode_g711_kernels[0][s->bits_per_sample - 6][s->packed](s, g711_data, len, g722_data);
+    G722_STATS(encoder_stats(s, NULL, len));
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode_alaw(G722_ENC_CTX *s, const uint8_t g711_data[], int len, uint8_t g722_data[])
+{
+    int g722_bytes;
+
+    if (!s->eight_k  ||  s->itu_test_mode)
+        return -1;
+    G722_STATS(g722_tally_reset());
+    g722_bytes = encode_g711_kernels[1][s->bits_per_sample - 6][s->packed](s, g711_data, len, g722_data);
+    G722_STATS(encoder_stats(s, NULL, len));
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode_48khz(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[])
+{
+    /* A decimated block, after any sample left over from the last one */
+    int16_t xbuf[1 + G722_RS_BLOCK/3 + 1];
+    const struct g722_rs_filter *f;
+    int g722_bytes;
+    int n;
+    int m;
+    int j;
+
+    if (s->itu_test_mode  ||  !s->rs48k)
+        return -1;
+    G722_STATS(g722_tally_reset());
+    f = (s->eight_k)  ?  &g722_rs_8k  :  &g722_rs_16k;
+    g722_bytes = 0;
+    for (j = 0;  j < len;  j += n)
+    {
+        n = len - j;
+        if (n > G722_RS_BLOCK)
+            n = G722_RS_BLOCK;
+        m = s->rs->pending;
+        xbuf[0] = s->rs->odd;
+        m += g722_rs_decimate(f, s->rs->hist, &s->rs->phase, amp + j, n, xbuf + m);
+        /* The QMF takes whole pairs, so an odd sample waits for the next */
+        s->rs->pending = FALSE;
+        if (!s->eight_k  &&  (m & 1))
         {
-            g722_data[g722_bytes++] = (uint8_t) code;
+            s->rs->odd = xbuf[--m];
+            s->rs->pending = TRUE;
         }
+        g722_bytes += s->encode(s, xbuf, m, g722_data + g722_bytes);
     }
+    G722_STATS(encoder_stats(s, amp, len));
     return g722_bytes;
 }
 /*- End of function --------------------------------------------------------*/
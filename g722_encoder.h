@@ -39,6 +39,68 @@ G722_ENC_CTX *g722_encoder_new(int rate, int options);
 int g722_encoder_destroy(G722_ENC_CTX *s);
 int g722_encode(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[]);
 
+/*! \return The number of bytes of memory an encoder context occupies, with
+            any options. One without G722_RESAMPLE_48000 needs less, but
+            this much will always do. */
+size_t g722_encoder_state_size(void);
+/*! Set up an encoder context in memory provided by the caller, in place of
+    g722_encoder_new(). The context needs no g722_encoder_destroy(), the
+    caller just reuses or frees the memory when done with it.
+    \param mem At least g722_encoder_state_size() bytes, aligned to
+           G722_STATE_ALIGN bytes.
+    \param rate The bit rate, as for g722_encoder_new().
+    \param options The options, as for g722_encoder_new().
+    \return The context, at mem, or NULL if mem is NULL or misaligned. */
+G722_ENC_CTX *g722_encoder_init(void *mem, int rate, int options);
+/*! Make a copy of an encoder context, which then encodes exactly as the
+    original would from here on. A context set up with g722_encoder_init()
+    can equally be copied, as g722_encoder_state_size() bytes, to other
+    suitably aligned memory.
+    \param s The context to copy.
+    \return The new context, to be freed with g722_encoder_destroy(), or
+            NULL if out of memory. */
+G722_ENC_CTX *g722_encoder_clone(const G722_ENC_CTX *s);
+/*! Check if two encoder contexts are in the same state, so that they will
+    turn the same input into the same output from here on. Contexts that
+    are fed the same input converge, after which all but one may be
+    dropped, and the survivor cloned again when the inputs diverge.
+    \param s1 One context.
+    \param s2 The other context.
+    \return Non-zero if the states are the same, zero if not. */
+int g722_encoder_state_equal(const G722_ENC_CTX *s1, const G722_ENC_CTX *s2);
+/*! Encode 8k samples/second G.711 audio straight to G.722, expanding
+    each sample as it is encoded rather than through a linear buffer. The
+    output is as g722_encode() gives for the expanded samples.
+    \param s An encoder context set up with G722_SAMPLE_RATE_8000, and not
+           in the ITU test mode.
+    \param g711_data The mu-law or A-law samples.
+    \param len The number of samples.
+    \param g722_data The G.722 output.
+    \return The number of G.722 bytes, or -1 if the context is not an 8k one. */
+int g722_encode_ulaw(G722_ENC_CTX *s, const uint8_t g711_data[], int len, uint8_t g722_data[]);
+int g722_encode_alaw(G722_ENC_CTX *s, const uint8_t g711_data[], int len, uint8_t g722_data[]);
+/*! Encode 48k samples/second linear audio, decimating it to the 16k (or
+    with G722_SAMPLE_RATE_8000 the 8k) samples/second the encoder takes on
+    the way in. The decimator's history is part of the context, so the
+    input may be split up anywhere.
+    \param s An encoder context set up with G722_RESAMPLE_48000, and not
+           in the ITU test mode.
+    \param amp The 48k samples/second audio.
+    \param len The number of samples.
+    \param g722_data The G.722 output, of up to len/6 + 1 codes.
+    \return The number of G.722 bytes, or -1 if the context is not set up
+            for 48k samples/second, or is in the ITU test mode. */
+int g722_encode_48khz(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[]);
+/*! Read the counters of an encoder context, which show how it has been
+    running, such as how often it clipped and which fast paths it took.
+    They are only kept when the library is built with G722_ENABLE_STATS,
+    and a clone starts with a copy of them.
+    \param s The context.
+    \param stats Set to the counters.
+    \return 0, or -1 if the library keeps no counters, in which case stats
+            is zeroed. */
+int g722_encoder_get_stats(const G722_ENC_CTX *s, struct g722_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,730 @@
+/*
+ * g722_engine.c - The ITU G.722 codec, threaded batch engine.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  Every job becomes a task. The last task submitted for each context is
+ *  kept in a hash table, sharded by context to keep the locks apart, and a
+ *  task submitted while an earlier one on its context is still queued or
+ *  running is chained behind it rather than queued. When a task is done
+ *  the next one on its context, if any, goes onto the deque of the worker
+ *  that ran it, where the context is still in cache.
+ */
+
+/*! \file */
+
+#if defined(__linux__)  &&  !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#define G722_ENGINE_THREADS
+#elif defined(__unix__)  ||  defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#define G722_ENGINE_THREADS
+#endif
+
+#include "g722_encoder.h"
+#include "g722_decoder.h"
+#include "g722_engine.h"
+
+/*! Shards of the context table, each with its own lock */
+#define ENGINE_SHARDS 64
+/*! Hash chains per shard */
+#define ENGINE_BUCKETS 256
+#define ENGINE_MAX_THREADS 256
+
+#if defined(_WIN32)
+typedef CRITICAL_SECTION engine_mutex_t;
+typedef CONDITION_VARIABLE engine_cond_t;
+typedef HANDLE engine_thread_t;
+#define engine_mutex_init(m) InitializeCriticalSection(m)
+#define engine_mutex_destroy(m) DeleteCriticalSection(m)
+#define engine_mutex_lock(m) EnterCriticalSection(m)
+#define engine_mutex_unlock(m) LeaveCriticalSection(m)
+#define engine_cond_init(c) InitializeConditionVariable(c)
+#define engine_cond_destroy(c) do { } while (0)
+#define engine_cond_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define engine_cond_broadcast(c) WakeAllConditionVariable(c)
+#define engine_atomic_add(p, v) InterlockedExchangeAdd((p), (v))
+#elif defined(G722_ENGINE_THREADS)
+typedef pthread_mutex_t engine_mutex_t;
+typedef pthread_cond_t engine_cond_t;
+typedef pthread_t engine_thread_t;
+#define engine_mutex_init(m) pthread_mutex_init(m, NULL)
+#define engine_mutex_destroy(m) pthread_mutex_destroy(m)
+#define engine_mutex_lock(m) pthread_mutex_lock(m)
+#define engine_mutex_unlock(m) pthread_mutex_unlock(m)
+#define engine_cond_init(c) pthread_cond_init(c, NULL)
+#define engine_cond_destroy(c) pthread_cond_destroy(c)
+#define engine_cond_wait(c, m) pthread_cond_wait(c, m)
+#define engine_cond_broadcast(c) pthread_cond_broadcast(c)
+#define engine_atomic_add(p, v) __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#else
+/* No threads, so nothing to lock against */
+typedef int engine_mutex_t;
+typedef int engine_cond_t;
+#define engine_mutex_init(m) do { } while (0)
+#define engine_mutex_destroy(m) do { } while (0)
+#define engine_mutex_lock(m) do { } while (0)
+#define engine_mutex_unlock(m) do { } while (0)
+#define engine_cond_init(c) do { } while (0)
+#define engine_cond_destroy(c) do { } while (0)
+#define engine_cond_wait(c, m) do { } while (0)
+#define engine_cond_broadcast(c) do { } while (0)
+#define engine_atomic_add(p, v) engine_plain_add((p), (v))
+#endif
+
+#if !defined(G722_ENGINE_THREADS)
+static long engine_plain_add(long *p, long v)
+{
+    *p += v;
+    return *p - v;
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+struct engine_batch;
+
+struct engine_task
+{
+    struct g722_job *job;
+    struct engine_batch *batch;
+    /*! The next task on the same context, waiting for this one */
+    struct engine_task *next_same;
+    /*! The hash chain, while this is the last task submitted for its context */
+    struct engine_task *hnext;
+};
+
+struct engine_batch
+{
+    struct g722_job *jobs;
+    int njobs;
+    /*! Tasks not yet done */
+    long remaining;
+    g722_batch_done_fn done;
+    void *arg;
+    struct engine_task task[];
+};
+
+/* A growable ring of tasks. The owner pushes and pops at the tail, thieves
+   take from the head. */
+struct engine_deque
+{
+    engine_mutex_t lock;
+    struct engine_task **ring;
+    int size;
+    int head;
+    int count;
+};
+
+struct engine_shard
+{
+    engine_mutex_t lock;
+    struct engine_task *bucket[ENGINE_BUCKETS];
+};
+
+struct engine_worker
+{
+    G722_ENGINE *e;
+    int index;
+#if defined(G722_ENGINE_THREADS)
+    engine_thread_t thread;
+#endif
+    struct engine_deque dq;
+};
+
+struct g722_engine
+{
+    int nworkers;
+    int options;
+    /*! Tasks sitting in the deques */
+    long queued;
+    /*! Tasks submitted and not yet done, which every deque has room for */
+    long inflight;
+    /*! Tasks ever handed out, to deal the next one to the next worker */
+    long dealt;
+
+    engine_mutex_t lock;
+    /*! Signalled when there is work, or the engine is stopping */
+    engine_cond_t work;
+    /*! Signalled when a batch is done */
+    engine_cond_t done;
+    int sleeping;
+    int stop;
+    /*! Batches submitted and not yet done */
+    int outstanding;
+
+    struct engine_shard shard[ENGINE_SHARDS];
+    /*! At least one, even with no worker threads */
+    struct engine_worker *worker;
+};
+
+struct engine_wait
+{
+    G722_ENGINE *e;
+    int finished;
+};
+
+static unsigned int engine_hash(const void *ctx)
+{
+    uint64_t h;
+
+    h = ((uint64_t) (uintptr_t) ctx >> 4)*UINT64_C(0x9E3779B97F4A7C15);
+    return (unsigned int) (h >> 40);
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Make room for at least len tasks */
+static int deque_grow(struct engine_deque *dq, long len)
+{
+    struct engine_task **ring;
+    int size;
+    int i;
+
+    engine_mutex_lock(&dq->lock);
+    size = (dq->size)  ?  dq->size  :  64;
+    while (size < len)
+        size *= 2;
+    if (size > dq->size)
+    {
+        if ((ring = (struct engine_task **) malloc(size*sizeof(ring[0]))) == NULL)
+        {
+            engine_mutex_unlock(&dq->lock);
+            return -1;
+        }
+        for (i = 0;  i < dq->count;  i++)
+            ring[i] = dq->ring[(dq->head + i) % dq->size];
+        free(dq->ring);
+        dq->ring = ring;
+        dq->size = size;
+        dq->head = 0;
+    }
+    engine_mutex_unlock(&dq->lock);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+static void deque_push(struct engine_deque *dq, struct engine_task *t)
+{
+    engine_mutex_lock(&dq->lock);
+    dq->ring[(dq->head + dq->count) % dq->size] = t;
+    dq->count++;
+    engine_mutex_unlock(&dq->lock);
+}
+/*- End of function --------------------------------------------------------*/
+
+static struct engine_task *deque_pop(struct engine_deque *dq)
+{
+    struct engine_task *t;
+
+    t = NULL;
+    engine_mutex_lock(&dq->lock);
+    if (dq->count > 0)
+    {
+        dq->count--;
+        t = dq->ring[(dq->head + dq->count) % dq->size];
+    }
+    engine_mutex_unlock(&dq->lock);
+    return t;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Queue a task that may run now */
+static void engine_queue(G722_ENGINE *e, int w, struct engine_task *t)
+{
+    /* Every ring has room for every task in flight, so this cannot fail */
+    deque_push(&e->worker[w].dq, t);
+    engine_atomic_add(&e->queued, 1);
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Register a task as the last on its context, and return TRUE if there is
+   no earlier one it has to wait for */
+static int engine_enter(G722_ENGINE *e, struct engine_task *t)
+{
+    struct engine_shard *sh;
+    struct engine_task **link;
+    unsigned int h;
+
+    h = engine_hash(t->job->ctx);
+    sh = &e->shard[h % ENGINE_SHARDS];
+    link = &sh->bucket[(h/ENGINE_SHARDS) % ENGINE_BUCKETS];
+    t->next_same = NULL;
+    engine_mutex_lock(&sh->lock);
+    for (  ;  *link;  link = &(*link)->hnext)
+    {
+        if ((*link)->job->ctx == t->job->ctx)
+        {
+            /* Take the place of the earlier task, and wait behind it */
+            (*link)->next_same = t;
+            t->hnext = (*link)->hnext;
+            *link = t;
+            engine_mutex_unlock(&sh->lock);
+            return 0;
+        }
+    }
+    t->hnext = NULL;
+    *link = t;
+    engine_mutex_unlock(&sh->lock);
+    return 1;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Retire a done task, and return the next task on its context, if any */
+static struct engine_task *engine_leave(G722_ENGINE *e, struct engine_task *t)
+{
+    struct engine_shard *sh;
+    struct engine_task **link;
+    struct engine_task *next;
+    unsigned int h;
+
+    h = engine_hash(t->job->ctx);
+    sh = &e->shard[h % ENGINE_SHARDS];
+    engine_mutex_lock(&sh->lock);
+    next = t->next_same;
+    if (next == NULL)
+    {
+        /* Still the last task on its context, so still in the table */
+        for (link = &sh->bucket[(h/ENGINE_SHARDS) % ENGINE_BUCKETS];  *link != t;  link = &(*link)->hnext)
+            ;
+        *link = t->hnext;
+    }
+    engine_mutex_unlock(&sh->lock);
+    return next;
+}
+/*- End of function --------------------------------------------------------*/
+
+static void engine_batch_done(G722_ENGINE *e, struct engine_batch *b)
+{
+    if (b->done)
+        b->done(b->arg, b->jobs, b->njobs);
+    free(b);
+    engine_mutex_lock(&e->lock);
+    e->outstanding--;
+    engine_cond_broadcast(&e->done);
+    engine_mutex_unlock(&e->lock);
+}
+/*- End of function --------------------------------------------------------*/
+
+static void engine_run_task(G722_ENGINE *e, int w, struct engine_task *t)
+{
+    struct g722_job *job;
+    struct engine_task *next;
+    struct engine_batch *b;
+
+    job = t->job;
+    if (job->op == G722_JOB_ENCODE)
+        job->result = g722_encode((G722_ENC_CTX *) job->ctx, (const int16_t *) job->in, job->len, (uint8_t *) job->out);
+    else
+        job->result = g722_decode((G722_DEC_CTX *) job->ctx, (const uint8_t *) job->in, job->len, (int16_t *) job->out);
+
+    b = t->batch;
+    if ((next = engine_leave(e, t)) != NULL)
+        engine_queue(e, w, next);
+    engine_atomic_add(&e->inflight, -1);
+    if (engine_atomic_add(&b->remaining, -1) == 1)
+        engine_batch_done(e, b);
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(G722_ENGINE_THREADS)
+static struct engine_task *deque_steal(struct engine_deque *dq)
+{
+    struct engine_task *t;
+
+    t = NULL;
+    engine_mutex_lock(&dq->lock);
+    if (dq->count > 0)
+    {
+        t = dq->ring[dq->head];
+        dq->head = (dq->head + 1) % dq->size;
+        dq->count--;
+    }
+    engine_mutex_unlock(&dq->lock);
+    return t;
+}
+/*- End of function --------------------------------------------------------*/
+
+static struct engine_task *engine_find(G722_ENGINE *e, int w)
+{
+    struct engine_task *t;
+    int i;
+
+    if ((t = deque_pop(&e->worker[w].dq)) != NULL)
+        return t;
+    for (i = 1;  i < e->nworkers;  i++)
+    {
+        if ((t = deque_steal(&e->worker[(w + i) % e->nworkers].dq)) != NULL)
+            return t;
+    }
+    return NULL;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Pin a worker to the one CPU of those the process may run on that its
+   index picks, so that a taskset or a cpuset is kept to */
+static void engine_pin(struct engine_worker *wk)
+{
+#if defined(_WIN32)
+    DWORD_PTR allowed;
+    DWORD_PTR system;
+    DWORD_PTR bit;
+    int ncpus;
+    int n;
+
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &allowed, &system))
+        return;
+    for (ncpus = 0, bit = 1;  bit;  bit <<= 1)
+        ncpus += ((allowed & bit) != 0);
+    if (ncpus == 0)
+        return;
+    n = wk->index % ncpus;
+    for (bit = 1;  bit;  bit <<= 1)
+    {
+        if ((allowed & bit)  &&  n-- == 0)
+            break;
+    }
+    SetThreadAffinityMask(GetCurrentThread(), bit);
+#elif defined(__linux__)
+    cpu_set_t allowed;
+    cpu_set_t set;
+    int ncpus;
+    int cpu;
+    int n;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0  ||  (ncpus = CPU_COUNT(&allowed)) == 0)
+        return;
+    n = wk->index % ncpus;
+    for (cpu = 0;  cpu < CPU_SETSIZE;  cpu++)
+    {
+        if (CPU_ISSET(cpu, &allowed)  &&  n-- == 0)
+            break;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void) wk;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+static void engine_worker_loop(struct engine_worker *wk)
+{
+    G722_ENGINE *e;
+    struct engine_task *t;
+    int stop;
+
+    e = wk->e;
+    if (!(e->options & G722_ENGINE_NO_PIN))
+        engine_pin(wk);
+    for (;;)
+    {
+        if ((t = engine_find(e, wk->index)) != NULL)
+        {
+            engine_atomic_add(&e->queued, -1);
+            engine_run_task(e, wk->index, t);
+            continue;
+        }
+        engine_mutex_lock(&e->lock);
+        while (engine_atomic_add(&e->queued, 0) == 0  &&  !e->stop)
+        {
+            e->sleeping++;
+            engine_cond_wait(&e->work, &e->lock);
+            e->sleeping--;
+        }
+        stop = (engine_atomic_add(&e->queued, 0) == 0  &&  e->stop);
+        engine_mutex_unlock(&e->lock);
+        if (stop)
+            break;
+    }
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(_WIN32)
+static DWORD WINAPI engine_thread(LPVOID arg)
+{
+    engine_worker_loop((struct engine_worker *) arg);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+#else
+static void *engine_thread(void *arg)
+{
+    engine_worker_loop((struct engine_worker *) arg);
+    return NULL;
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+#endif
+
+static void engine_free(G722_ENGINE *e, int nstarted)
+{
+    int i;
+
+#if defined(G722_ENGINE_THREADS)
+    engine_mutex_lock(&e->lock);
+    e->stop = 1;
+    engine_cond_broadcast(&e->work);
+    engine_mutex_unlock(&e->lock);
+    for (i = 0;  i < nstarted;  i++)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(e->worker[i].thread, INFINITE);
+        CloseHandle(e->worker[i].thread);
+#else
+        pthread_join(e->worker[i].thread, NULL);
+#endif
+    }
+#else
+    (void) nstarted;
+#endif
+    for (i = 0;  i < ((e->nworkers)  ?  e->nworkers  :  1);  i++)
+    {
+        engine_mutex_destroy(&e->worker[i].dq.lock);
+        free(e->worker[i].dq.ring);
+    }
+    for (i = 0;  i < ENGINE_SHARDS;  i++)
+        engine_mutex_destroy(&e->shard[i].lock);
+    engine_cond_destroy(&e->work);
+    engine_cond_destroy(&e->done);
+    engine_mutex_destroy(&e->lock);
+    free(e->worker);
+    free(e);
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_ENGINE *g722_engine_new(int threads, int options)
+{
+    G722_ENGINE *e;
+    int nqueues;
+    int i;
+
+    if ((e = (G722_ENGINE *) calloc(1, sizeof(*e))) == NULL)
+        return NULL;
+#if defined(G722_ENGINE_THREADS)
+    if (threads <= 0)
+        threads = g722_engine_cpus();
+    if (threads > ENGINE_MAX_THREADS)
+        threads = ENGINE_MAX_THREADS;
+#else
+    threads = 0;
+#endif
+    nqueues = (threads)  ?  threads  :  1;
+    if ((e->worker = (struct engine_worker *) calloc(nqueues, sizeof(e->worker[0]))) == NULL)
+    {
+        free(e);
+        return NULL;
+    }
+    e->nworkers = threads;
+    e->options = options;
+    engine_mutex_init(&e->lock);
+    engine_cond_init(&e->work);
+    engine_cond_init(&e->done);
+    for (i = 0;  i < ENGINE_SHARDS;  i++)
+        engine_mutex_init(&e->shard[i].lock);
+    for (i = 0;  i < nqueues;  i++)
+    {
+        e->worker[i].e = e;
+        e->worker[i].index = i;
+        engine_mutex_init(&e->worker[i].dq.lock);
+    }
+#if defined(G722_ENGINE_THREADS)
+    for (i = 0;  i < threads;  i++)
+    {
+#if defined(_WIN32)
+        e->worker[i].thread = CreateThread(NULL, 0, engine_thread, &e->worker[i], 0, NULL);
+        if (e->worker[i].thread == NULL)
+#else
+        if (pthread_create(&e->worker[i].thread, NULL, engine_thread, &e->worker[i]) != 0)
+#endif
+        {
+            engine_free(e, i);
+            return NULL;
+        }
+    }
+#endif
+    return e;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_engine_cpus(void)
+{
+#if defined(_WIN32)
+    DWORD_PTR allowed;
+    DWORD_PTR system;
+    SYSTEM_INFO si;
+    int n;
+
+    if (GetProcessAffinityMask(GetCurrentProcess(), &allowed, &system))
+    {
+        for (n = 0;  allowed;  allowed &= allowed - 1)
+            n++;
+        if (n > 0)
+            return n;
+    }
+    GetSystemInfo(&si);
+    return (int) si.dwNumberOfProcessors;
+#elif defined(G722_ENGINE_THREADS)
+    long n;
+#if defined(__linux__)
+    cpu_set_t allowed;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0  &&  CPU_COUNT(&allowed) > 0)
+        return CPU_COUNT(&allowed);
+#endif
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0)  ?  (int) n  :  1;
+#else
+    return 1;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_engine_threads(const G722_ENGINE *e)
+{
+    return e->nworkers;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_engine_destroy(G722_ENGINE *e)
+{
+    engine_mutex_lock(&e->lock);
+    while (e->outstanding > 0)
+        engine_cond_wait(&e->done, &e->lock);
+    engine_mutex_unlock(&e->lock);
+    engine_free(e, e->nworkers);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Make room in every deque for the tasks of a batch, on top of those in
+   flight, so that queueing them, and the tasks they release, cannot fail
+   half way. Called with the engine lock held, so that batches submitted
+   at the same time are counted one after the other. */
+static int engine_reserve(G722_ENGINE *e, int njobs)
+{
+    long len;
+    int i;
+
+    len = engine_atomic_add(&e->inflight, 0) + njobs;
+    for (i = 0;  i < ((e->nworkers)  ?  e->nworkers  :  1);  i++)
+    {
+        if (deque_grow(&e->worker[i].dq, len) < 0)
+            return -1;
+    }
+    engine_atomic_add(&e->inflight, njobs);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_engine_submit(G722_ENGINE *e, struct g722_job jobs[], int njobs, g722_batch_done_fn done, void *arg)
+{
+    struct engine_batch *b;
+    struct engine_task *t;
+    int w;
+    int i;
+
+    for (i = 0;  i < njobs;  i++)
+    {
+        if ((jobs[i].op != G722_JOB_ENCODE  &&  jobs[i].op != G722_JOB_DECODE)  ||  jobs[i].ctx == NULL)
+            return -1;
+    }
+    if (njobs <= 0)
+    {
+        if (done)
+            done(arg, jobs, 0);
+        return 0;
+    }
+    b = (struct engine_batch *) malloc(sizeof(*b) + njobs*sizeof(b->task[0]));
+    if (b == NULL)
+        return -1;
+    engine_mutex_lock(&e->lock);
+    if (engine_reserve(e, njobs) < 0)
+    {
+        engine_mutex_unlock(&e->lock);
+        free(b);
+        return -1;
+    }
+    e->outstanding++;
+    engine_mutex_unlock(&e->lock);
+    b->jobs = jobs;
+    b->njobs = njobs;
+    b->remaining = njobs;
+    b->done = done;
+    b->arg = arg;
+
+    w = 0;
+    if (e->nworkers > 1)
+        w = (int) ((unsigned long) engine_atomic_add(&e->dealt, njobs) % e->nworkers);
+    for (i = 0;  i < njobs;  i++)
+    {
+        t = &b->task[i];
+        t->job = &jobs[i];
+        t->batch = b;
+        if (engine_enter(e, t))
+        {
+            engine_queue(e, w, t);
+            if (++w >= e->nworkers)
+                w = 0;
+        }
+    }
+
+    if (e->nworkers == 0)
+    {
+        /* No threads, so run the batch, and whatever it releases, here */
+        while ((t = deque_pop(&e->worker[0].dq)) != NULL)
+        {
+            engine_atomic_add(&e->queued, -1);
+            engine_run_task(e, 0, t);
+        }
+        return 0;
+    }
+    engine_mutex_lock(&e->lock);
+    if (e->sleeping)
+        engine_cond_broadcast(&e->work);
+    engine_mutex_unlock(&e->lock);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+static void engine_run_done(void *arg, struct g722_job jobs[], int njobs)
+{
+    struct engine_wait *w;
+
+    (void) jobs;
+    (void) njobs;
+    w = (struct engine_wait *) arg;
+    /* The waiter is woken once the batch is retired */
+    engine_mutex_lock(&w->e->lock);
+    w->finished = 1;
+    engine_mutex_unlock(&w->e->lock);
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_engine_run(G722_ENGINE *e, struct g722_job jobs[], int njobs)
+{
+    struct engine_wait w;
+
+    w.e = e;
+    w.finished = 0;
+    if (g722_engine_submit(e, jobs, njobs, engine_run_done, &w) < 0)
+        return -1;
+    engine_mutex_lock(&e->lock);
+    while (!w.finished)
+        engine_cond_wait(&e->done, &e->lock);
+    engine_mutex_unlock(&e->lock);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
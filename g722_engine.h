@@ -0,0 +1,100 @@
+/*
+ * g722_engine.h - The ITU G.722 codec, threaded batch engine.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ */
+
+
+/*! \file */
+
+#pragma once
+
+#include "g722.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \page g722_engine_page Batch G.722 encoding and decoding on many threads
+\section g722_engine_page_sec_1 What does it do?
+The engine runs batches of encode and decode jobs, each on its own encoder
+or decoder context, over a fixed set of worker threads. Each worker has a
+deque of jobs, which it works through newest first, and when it runs out
+it steals the oldest job from another worker's deque.
+
+Jobs on the same context run one at a time, in the order they were
+submitted, within a batch and across batches. Jobs on different contexts
+run in any order, and in parallel.
+
+Where the platform has no threads the engine has no workers, and batches
+run to completion on the submitting thread.
+*/
+
+typedef struct g722_engine G722_ENGINE;
+
+/*! What a job does */
+enum
+{
+    /*! g722_encode() on a G722_ENC_CTX, from int16_t samples to bytes */
+    G722_JOB_ENCODE = 0,
+    /*! g722_decode() on a G722_DEC_CTX, from bytes to int16_t samples */
+    G722_JOB_DECODE = 1
+};
+
+/*! Engine options */
+enum
+{
+    /*! Leave the workers free to run on any CPU, rather than one each */
+    G722_ENGINE_NO_PIN = 0x0001
+};
+
+struct g722_job
+{
+    /*! G722_JOB_ENCODE or G722_JOB_DECODE */
+    int op;
+    /*! The context, which must not be used outside the engine until
+        every job on it is done */
+    void *ctx;
+    const void *in;
+    /*! The number of samples to encode, or bytes to decode */
+    int len;
+    void *out;
+    /*! Set when the job is done, to what the encode or decode returned */
+    int result;
+};
+
+/*! Called on a worker thread once every job of a batch is done.
+    \param arg The argument given to g722_engine_submit().
+    \param jobs The jobs of the batch, with their results.
+    \param njobs The number of jobs. */
+typedef void (*g722_batch_done_fn)(void *arg, struct g722_job jobs[], int njobs);
+
+/*! Start an engine.
+    \param threads The number of worker threads, or 0 for one per CPU.
+    \param options Zero or more G722_ENGINE_ options.
+    \return The engine, or NULL if out of memory or a thread could not be started. */
+G722_ENGINE *g722_engine_new(int threads, int options);
+/*! Wait for every batch submitted to finish, and stop the engine. */
+int g722_engine_destroy(G722_ENGINE *e);
+/*! \return The number of worker threads, 0 if batches run on the submitting thread. */
+int g722_engine_threads(const G722_ENGINE *e);
+/*! \return The number of CPUs the process may run on, which is what a
+            threads of 0 in g722_engine_new() starts. Under a taskset or in
+            a container this can be fewer than are online. */
+int g722_engine_cpus(void);
+/*! Queue a batch of jobs, and return without waiting for them.
+    \param e The engine.
+    \param jobs The jobs, which must stay in place until the batch is done.
+    \param njobs The number of jobs.
+    \param done Called once every job is done, or NULL.
+    \param arg The argument for done.
+    \return 0, or -1 if a job is invalid or out of memory, in which case
+            nothing is queued. */
+int g722_engine_submit(G722_ENGINE *e, struct g722_job jobs[], int njobs, g722_batch_done_fn done, void *arg);
+/*! Run a batch of jobs, and wait for all of them to be done.
+    \return 0, or -1 as for g722_engine_submit(). */
+int g722_engine_run(G722_ENGINE *e, struct g722_job jobs[], int njobs);
+
+#ifdef __cplusplus
+}
+#endif
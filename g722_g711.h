@@ -0,0 +1,105 @@
+/*
+ * g722_g711.h - The ITU G.722 codec, G.711 conversions for transcoding.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  The G.711 mu-law and A-law conversions of the classic Sun reference
+ *  code, for the encoder and the decoder to fold into their 8k sample loops.
+ *  Expansion is a table lookup, compression finds the segment from the bit
+ *  length of the magnitude rather than by searching the segment ends.
+ */
+
+/*! \file */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "g722_tables.h"
+
+/* Where the 8k samples/second linear audio comes from or goes to */
+#define G722_LAW_LINEAR 0
+#define G722_LAW_ULAW 1
+#define G722_LAW_ALAW 2
+
+/* The number of significant bits of v, for v in 0 to 255 */
+static inline int g722_bit_length8(int v)
+{
+    int n;
+    int t;
+
+    n = (v > 15) << 2;
+    v >>= n;
+    t = (v > 3) << 1;
+    n += t;
+    v >>= t;
+    t = (v > 1);
+    n += t;
+    v >>= t;
+    return n + v;
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline int g722_ulaw_to_linear(uint8_t ulaw)
+{
+    return g722_tables.ulaw[ulaw];
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline int g722_alaw_to_linear(uint8_t alaw)
+{
+    return g722_tables.alaw[alaw];
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline uint8_t g722_linear_to_ulaw(int linear)
+{
+    int mask;
+    int seg;
+    int v;
+
+    v = linear >> 2;
+    if (v < 0)
+    {
+        v = -v;
+        mask = 0x7F;
+    }
+    else
+    {
+        mask = 0xFF;
+    }
+    if (v > 8159)
+        v = 8159;
+    /* Add the bias, so the segment ends are 0x3F, 0x7F, ... 0x1FFF */
+    v += 0x84 >> 2;
+    seg = g722_bit_length8(v >> 6);
+    if (seg >= 8)
+        return (uint8_t) (0x7F ^ mask);
+    return (uint8_t) (((seg << 4) | ((v >> (seg + 1)) & 0x0F)) ^ mask);
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline uint8_t g722_linear_to_alaw(int linear)
+{
+    int mask;
+    int seg;
+    int v;
+
+    v = linear >> 3;
+    if (v >= 0)
+    {
+        mask = 0xD5;
+    }
+    else
+    {
+        mask = 0x55;
+        v = -v - 1;
+    }
+    /* The segment ends are 0x1F, 0x3F, ... 0xFFF, and v is at most 0xFFF */
+    seg = g722_bit_length8(v >> 5);
+    if (seg < 2)
+        return (uint8_t) (((seg << 4) | ((v >> 1) & 0x0F)) ^ mask);
+    return (uint8_t) (((seg << 4) | ((v >> seg) & 0x0F)) ^ mask);
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
@@ -0,0 +1,694 @@
+/*
+ * g722_multi.c - The ITU G.722 codec, multi-channel encoder and decoder.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  The channels are kept in groups of G722_MULTI_GROUP, with every band
+ *  state field stored as one array across the group (structure of arrays),
+ *  so that one vector instruction advances one field for many channels.
+ *  The QMFs and the bit packing are per channel work, done outside the
+ *  lanes, using the same block QMF kernels as the single channel codec.
+ */
+
+/*! \file */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g722_private.h"
+#include "g722_common.h"
+#include "g722_cpu.h"
+#include "g722_multi.h"
+
+/*! Channels per lane group, the widest vector we use (AVX-512, 16 x 32 bits). */
+#define G722_MULTI_GROUP 16
+/*! Samples per channel run through the lanes in one go. */
+#define G722_MULTI_BLOCK 64
+
+struct g722_lane_band
+{
+    int32_t s[G722_MULTI_GROUP];
+    int32_t sz[G722_MULTI_GROUP];
+    int32_t r[3][G722_MULTI_GROUP];
+    int32_t a[3][G722_MULTI_GROUP];
+    int32_t p[3][G722_MULTI_GROUP];
+    int32_t d[7][G722_MULTI_GROUP];
+    int32_t b[7][G722_MULTI_GROUP];
+    int32_t nb[G722_MULTI_GROUP];
+    int32_t det[G722_MULTI_GROUP];
+};
+
+struct g722_lane_group
+{
+    struct g722_lane_band band[2];
+};
+
+/* Lane data for one block: the QMF side signals and the codes */
+struct g722_lane_block
+{
+    int32_t x[G722_MULTI_BLOCK][2][G722_MULTI_GROUP];
+    int32_t code[G722_MULTI_BLOCK][G722_MULTI_GROUP];
+};
+
+typedef void (*g722_lanes_enc_fn)(struct g722_lane_group *g, const int32_t x[][2][G722_MULTI_GROUP],
+  int n, int32_t code[][G722_MULTI_GROUP], int eight_k, int shift);
+typedef void (*g722_lanes_dec_fn)(struct g722_lane_group *g, const int32_t code[][G722_MULTI_GROUP],
+  int n, int32_t x[][2][G722_MULTI_GROUP], int eight_k, int bits_per_sample);
+
+/* Per channel bit packing state */
+struct g722_multi_bits
+{
+    unsigned int buffer;
+    int bits;
+};
+
+struct g722_multi_common
+{
+    int channels;
+    int groups;
+    /*! TRUE if the G.722 data is packed */
+    int packed;
+    /*! TRUE if coding from/to 8k samples/second */
+    int eight_k;
+    /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
+    int bits_per_sample;
+    g722_qmf_fn qmf;
+    /*! The lane groups, aligned to 64 bytes */
+    struct g722_lane_group *group;
+    struct g722_lane_block *block;
+    /*! Signal history for the QMF of each channel */
+    int16_t (*x)[G722_QMF_HIST];
+    struct g722_multi_bits *bits;
+    void *mem;
+};
+
+struct g722_multi_encode_state
+{
+    struct g722_multi_common c;
+    g722_lanes_enc_fn lanes;
+};
+
+struct g722_multi_decode_state
+{
+    struct g722_multi_common c;
+    g722_lanes_dec_fn lanes;
+};
+
+static const int32_t lane_q6[32] =
+{
+       0,   35,   72,  110,  150,  190,  233,  276,
+     323,  370,  422,  473,  530,  587,  650,  714,
+     786,  858,  940, 1023, 1121, 1219, 1339, 1458,
+    1612, 1765, 1980, 2195, 2557, 2919,    0,    0
+};
+static const int32_t lane_ilb[32] =
+{
+    2048, 2093, 2139, 2186, 2233, 2282, 2332,
+    2383, 2435, 2489, 2543, 2599, 2656, 2714,
+    2774, 2834, 2896, 2960, 3025, 3091, 3158,
+    3228, 3298, 3371, 3444, 3520, 3597, 3676,
+    3756, 3838, 3922, 4008
+};
+/* wl[rl42[i]] */
+static const int32_t lane_wl_rl42[16] =
+{
+    -60, 3042, 1198, 538, 334, 172, 58, -30,
+    3042, 1198, 538, 334, 172, 58, -30, -60
+};
+/* wh[rh2[i]] */
+static const int32_t lane_wh_rh2[4] = {798, -214, 798, -214};
+static const int32_t lane_qm2[4] = {-7408, -1616, 7408, 1616};
+static const int32_t lane_qm4[16] =
+{
+         0, -20456, -12896, -8968,
+     -6288,  -4240,  -2584, -1200,
+     20456,  12896,   8968,  6288,
+      4240,   2584,   1200,     0
+};
+static const int32_t lane_qm5[32] =
+{
+       -280,   -280, -23352, -17560,
+     -14120, -11664,  -9752,  -8184,
+      -6864,  -5712,  -4696,  -3784,
+      -2960,  -2208,  -1520,   -880,
+      23352,  17560,  14120,  11664,
+       9752,   8184,   6864,   5712,
+       4696,   3784,   2960,   2208,
+       1520,    880,    280,   -280
+};
+static const int32_t lane_qm6[64] =
+{
+       -136,   -136,   -136,   -136,
+     -24808, -21904, -19008, -16704,
+     -14984, -13512, -12280, -11192,
+     -10232,  -9360,  -8576,  -7856,
+      -7192,  -6576,  -6000,  -5456,
+      -4944,  -4464,  -4008,  -3576,
+      -3168,  -2776,  -2400,  -2032,
+      -1688,  -1360,  -1040,   -728,
+      24808,  21904,  19008,  16704,
+      14984,  13512,  12280,  11192,
+      10232,   9360,   8576,   7856,
+       7192,   6576,   6000,   5456,
+       4944,   4464,   4008,   3576,
+       3168,   2776,   2400,   2032,
+       1688,   1360,   1040,    728,
+        432,    136,   -432,   -136
+};
+
+/* The portable flavour, 8 lanes in plain C */
+#define LANES_GENERIC_W 8
+
+typedef struct
+{
+    int32_t v[LANES_GENERIC_W];
+} g722_v8;
+
+#define V8_OP2(name, expr) \
+static inline g722_v8 name(g722_v8 a, g722_v8 b) \
+{ \
+    g722_v8 r; \
+    int l; \
+    for (l = 0;  l < LANES_GENERIC_W;  l++) \
+        r.v[l] = (expr); \
+    return r; \
+}
+
+V8_OP2(v8_add, a.v[l] + b.v[l])
+V8_OP2(v8_sub, a.v[l] - b.v[l])
+V8_OP2(v8_mul, a.v[l]*b.v[l])
+V8_OP2(v8_and, a.v[l] & b.v[l])
+V8_OP2(v8_xor, a.v[l] ^ b.v[l])
+V8_OP2(v8_min, (a.v[l] < b.v[l])  ?  a.v[l]  :  b.v[l])
+V8_OP2(v8_max, (a.v[l] > b.v[l])  ?  a.v[l]  :  b.v[l])
+V8_OP2(v8_cmpgt, (a.v[l] > b.v[l])  ?  -1  :  0)
+V8_OP2(v8_cmpeq, (a.v[l] == b.v[l])  ?  -1  :  0)
+V8_OP2(v8_srav, a.v[l] >> b.v[l])
+
+static inline g722_v8 v8_load(const int32_t *p)
+{
+    g722_v8 r;
+
+    memcpy(r.v, p, sizeof(r.v));
+    return r;
+}
+
+static inline void v8_store(int32_t *p, g722_v8 a)
+{
+    memcpy(p, a.v, sizeof(a.v));
+}
+
+static inline g722_v8 v8_set1(int32_t x)
+{
+    g722_v8 r;
+    int l;
+
+    for (l = 0;  l < LANES_GENERIC_W;  l++)
+        r.v[l] = x;
+    return r;
+}
+
+static inline g722_v8 v8_srai(g722_v8 a, int n)
+{
+    return v8_srav(a, v8_set1(n));
+}
+
+static inline g722_v8 v8_slli(g722_v8 a, int n)
+{
+    return v8_mul(a, v8_set1(1 << n));
+}
+
+static inline g722_v8 v8_sel(g722_v8 m, g722_v8 a, g722_v8 b)
+{
+    g722_v8 r;
+    int l;
+
+    for (l = 0;  l < LANES_GENERIC_W;  l++)
+        r.v[l] = m.v[l]  ?  a.v[l]  :  b.v[l];
+    return r;
+}
+
+static inline g722_v8 v8_gather(const int32_t *t, g722_v8 i)
+{
+    g722_v8 r;
+    int l;
+
+    for (l = 0;  l < LANES_GENERIC_W;  l++)
+        r.v[l] = t[i.v[l]];
+    return r;
+}
+
+#define LANES_W LANES_GENERIC_W
+#define LANES_FN(name) name ## _generic
+#define LANES_TARGET
+#define VT g722_v8
+#define MT g722_v8
+#define V_LOAD(p) v8_load(p)
+#define V_STORE(p, a) v8_store(p, a)
+#define V_SET1(x) v8_set1(x)
+#define V_ADD(a, b) v8_add(a, b)
+#define V_SUB(a, b) v8_sub(a, b)
+#define V_MUL(a, b) v8_mul(a, b)
+#define V_AND(a, b) v8_and(a, b)
+#define V_XOR(a, b) v8_xor(a, b)
+#define V_MIN(a, b) v8_min(a, b)
+#define V_MAX(a, b) v8_max(a, b)
+#define V_SRAI(a, n) v8_srai(a, n)
+#define V_SLLI(a, n) v8_slli(a, n)
+#define V_SRAV(a, n) v8_srav(a, n)
+#define V_CMPGT(a, b) v8_cmpgt(a, b)
+#define V_CMPEQ(a, b) v8_cmpeq(a, b)
+#define V_SEL(m, a, b) v8_sel(m, a, b)
+#define V_GATHER(t, i) v8_gather(t, i)
+#include "g722_multi_lanes.h"
+#undef LANES_W
+#undef LANES_FN
+#undef LANES_TARGET
+#undef VT
+#undef MT
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_AND
+#undef V_XOR
+#undef V_MIN
+#undef V_MAX
+#undef V_SRAI
+#undef V_SLLI
+#undef V_SRAV
+#undef V_CMPGT
+#undef V_CMPEQ
+#undef V_SEL
+#undef V_GATHER
+
+#if defined(G722_CPU_AVX)
+#define LANES_W 8
+#define LANES_FN(name) name ## _avx2
+#define LANES_TARGET G722_TARGET("avx2")
+#define VT __m256i
+#define MT __m256i
+#define V_LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+#define V_STORE(p, a) _mm256_storeu_si256((__m256i *) (p), a)
+#define V_SET1(x) _mm256_set1_epi32(x)
+#define V_ADD(a, b) _mm256_add_epi32(a, b)
+#define V_SUB(a, b) _mm256_sub_epi32(a, b)
+#define V_MUL(a, b) _mm256_mullo_epi32(a, b)
+#define V_AND(a, b) _mm256_and_si256(a, b)
+#define V_XOR(a, b) _mm256_xor_si256(a, b)
+#define V_MIN(a, b) _mm256_min_epi32(a, b)
+#define V_MAX(a, b) _mm256_max_epi32(a, b)
+#define V_SRAI(a, n) _mm256_srai_epi32(a, n)
+#define V_SLLI(a, n) _mm256_slli_epi32(a, n)
+#define V_SRAV(a, n) _mm256_srav_epi32(a, n)
+#define V_CMPGT(a, b) _mm256_cmpgt_epi32(a, b)
+#define V_CMPEQ(a, b) _mm256_cmpeq_epi32(a, b)
+#define V_SEL(m, a, b) _mm256_blendv_epi8(b, a, m)
+#define V_GATHER(t, i) _mm256_i32gather_epi32((const int *) (t), i, 4)
+#include "g722_multi_lanes.h"
+#undef LANES_W
+#undef LANES_FN
+#undef LANES_TARGET
+#undef VT
+#undef MT
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_AND
+#undef V_XOR
+#undef V_MIN
+#undef V_MAX
+#undef V_SRAI
+#undef V_SLLI
+#undef V_SRAV
+#undef V_CMPGT
+#undef V_CMPEQ
+#undef V_SEL
+#undef V_GATHER
+
+#define LANES_W 16
+#define LANES_FN(name) name ## _avx512
+#define LANES_TARGET G722_TARGET("avx512f")
+#define VT __m512i
+#define MT __mmask16
+#define V_LOAD(p) _mm512_loadu_si512((const void *) (p))
+#define V_STORE(p, a) _mm512_storeu_si512((void *) (p), a)
+#define V_SET1(x) _mm512_set1_epi32(x)
+#define V_ADD(a, b) _mm512_add_epi32(a, b)
+#define V_SUB(a, b) _mm512_sub_epi32(a, b)
+#define V_MUL(a, b) _mm512_mullo_epi32(a, b)
+#define V_AND(a, b) _mm512_and_si512(a, b)
+#define V_XOR(a, b) _mm512_xor_si512(a, b)
+#define V_MIN(a, b) _mm512_min_epi32(a, b)
+#define V_MAX(a, b) _mm512_max_epi32(a, b)
+#define V_SRAI(a, n) _mm512_srai_epi32(a, n)
+#define V_SLLI(a, n) _mm512_slli_epi32(a, n)
+#define V_SRAV(a, n) _mm512_srav_epi32(a, n)
+#define V_CMPGT(a, b) _mm512_cmpgt_epi32_mask(a, b)
+#define V_CMPEQ(a, b) _mm512_cmpeq_epi32_mask(a, b)
+#define V_SEL(m, a, b) _mm512_mask_blend_epi32(m, b, a)
+#define V_GATHER(t, i) _mm512_i32gather_epi32(i, (const void *) (t), 4)
+#include "g722_multi_lanes.h"
+#undef LANES_W
+#undef LANES_FN
+#undef LANES_TARGET
+#undef VT
+#undef MT
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_AND
+#undef V_XOR
+#undef V_MIN
+#undef V_MAX
+#undef V_SRAI
+#undef V_SLLI
+#undef V_SRAV
+#undef V_CMPGT
+#undef V_CMPEQ
+#undef V_SEL
+#undef V_GATHER
+#endif
+
+static int multi_init(struct g722_multi_common *c, int channels, int rate, int options)
+{
+    size_t groups_size;
+    size_t size;
+    uintptr_t p;
+    int ch;
+    int g;
+
+    if (channels <= 0)
+        return -1;
+    memset(c, 0, sizeof(*c));
+    c->channels = channels;
+    c->groups = (channels + G722_MULTI_GROUP - 1)/G722_MULTI_GROUP;
+    if (rate == 48000)
+        c->bits_per_sample = 6;
+    else if (rate == 56000)
+        c->bits_per_sample = 7;
+    else
+        c->bits_per_sample = 8;
+    if ((options & G722_SAMPLE_RATE_8000))
+        c->eight_k = TRUE;
+    if ((options & G722_PACKED)  &&  c->bits_per_sample != 8)
+        c->packed = TRUE;
+    else
+        c->packed = FALSE;
+    c->qmf = g722_qmf_select();
+
+    /* One allocation, with the lane data cache line aligned up front */
+    groups_size = c->groups*sizeof(c->group[0]);
+    size = 63 + groups_size + sizeof(*c->block)
+         + channels*(sizeof(c->x[0]) + sizeof(c->bits[0]));
+    if ((c->mem = malloc(size)) == NULL)
+        return -1;
+    memset(c->mem, 0, size);
+    p = ((uintptr_t) c->mem + 63) & ~(uintptr_t) 63;
+    c->group = (struct g722_lane_group *) p;
+    c->block = (struct g722_lane_block *) (p + groups_size);
+    c->bits = (struct g722_multi_bits *) (c->block + 1);
+    c->x = (int16_t (*)[G722_QMF_HIST]) (c->bits + channels);
+    for (g = 0;  g < c->groups;  g++)
+    {
+        for (ch = 0;  ch < G722_MULTI_GROUP;  ch++)
+        {
+            c->group[g].band[0].det[ch] = 32;
+            c->group[g].band[1].det[ch] = 8;
+        }
+    }
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_MENC_CTX *g722_multi_encoder_new(int channels, int rate, int options)
+{
+    G722_MENC_CTX *s;
+
+    if ((s = (G722_MENC_CTX *) malloc(sizeof(*s))) == NULL)
+        return NULL;
+    if (multi_init(&s->c, channels, rate, options) != 0)
+    {
+        free(s);
+        return NULL;
+    }
+    s->lanes = encode_block_generic;
+#if defined(G722_CPU_AVX)
+    if (g722_cpu_has_avx512f())
+        s->lanes = encode_block_avx512;
+    else if (g722_cpu_has_avx2())
+        s->lanes = encode_block_avx2;
+#endif
+    return s;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_multi_encoder_destroy(G722_MENC_CTX *s)
+{
+    free(s->c.mem);
+    free(s);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_multi_encode(G722_MENC_CTX *s, const int16_t * const amp[], int len, uint8_t * const g722_data[])
+{
+    struct g722_multi_common *c;
+    struct g722_lane_block *blk;
+    int16_t xbuf[G722_QMF_HIST + 2*G722_MULTI_BLOCK];
+    int16_t xband[2*G722_MULTI_BLOCK];
+    struct g722_multi_bits *bits;
+    const int16_t *in;
+    uint8_t *out;
+    int g722_bytes;
+    int nbytes;
+    int step;
+    int done;
+    int lane;
+    int ch;
+    int n;
+    int g;
+    int k;
+
+    c = &s->c;
+    blk = c->block;
+    step = (c->eight_k)  ?  1  :  2;
+    g722_bytes = 0;
+    for (g = 0;  g < c->groups;  g++)
+    {
+        /* Every group writes the same number of bytes per channel */
+        g722_bytes = 0;
+        for (done = 0;  done + step <= len;  done += n*step)
+        {
+            n = (len - done)/step;
+            if (n > G722_MULTI_BLOCK)
+                n = G722_MULTI_BLOCK;
+
+            /* Split each channel of the group into its lane */
+            for (lane = 0;  lane < G722_MULTI_GROUP;  lane++)
+            {
+                ch = g*G722_MULTI_GROUP + lane;
+                if (ch >= c->channels)
+                {
+                    /* Idle lanes just see silence */
+                    for (k = 0;  k < n;  k++)
+                        blk->x[k][0][lane] = blk->x[k][1][lane] = 0;
+                    continue;
+                }
+                in = amp[ch] + done;
+                if (c->eight_k)
+                {
+                    for (k = 0;  k < n;  k++)
+                        blk->x[k][0][lane] = in[k] >> 1;
+                    continue;
+                }
+                /* Apply the transmit QMF */
+                memcpy(xbuf, c->x[ch], sizeof(c->x[ch]));
+                memcpy(xbuf + G722_QMF_HIST, in, 2*n*sizeof(in[0]));
+                c->qmf(xbuf, n, 14, &g722_qmf_tx_taps, xband);
+                memcpy(c->x[ch], xbuf + 2*n, sizeof(c->x[ch]));
+                for (k = 0;  k < n;  k++)
+                {
+                    blk->x[k][0][lane] = xband[2*k];
+                    blk->x[k][1][lane] = xband[2*k + 1];
+                }
+            }
+
+            s->lanes(&c->group[g], (const int32_t (*)[2][G722_MULTI_GROUP]) blk->x, n, blk->code,
+                     c->eight_k, 8 - c->bits_per_sample);
+
+            /* Collect the codes of each channel */
+            nbytes = 0;
+            for (lane = 0;  lane < G722_MULTI_GROUP;  lane++)
+            {
+                ch = g*G722_MULTI_GROUP + lane;
+                if (ch >= c->channels)
+                    break;
+                out = g722_data[ch] + g722_bytes;
+                if (!c->packed)
+                {
+                    for (k = 0;  k < n;  k++)
+                        out[k] = (uint8_t) blk->code[k][lane];
+                    nbytes = n;
+                    continue;
+                }
+                bits = &c->bits[ch];
+                nbytes = 0;
+                for (k = 0;  k < n;  k++)
+                {
+                    /* Pack the code bits */
+                    bits->buffer |= (blk->code[k][lane] << bits->bits);
+                    bits->bits += c->bits_per_sample;
+                    if (bits->bits >= 8)
+                    {
+                        out[nbytes++] = (uint8_t) (bits->buffer & 0xFF);
+                        bits->bits -= 8;
+                        bits->buffer >>= 8;
+                    }
+                }
+            }
+            g722_bytes += nbytes;
+        }
+    }
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+G722_MDEC_CTX *g722_multi_decoder_new(int channels, int rate, int options)
+{
+    G722_MDEC_CTX *s;
+
+    if ((s = (G722_MDEC_CTX *) malloc(sizeof(*s))) == NULL)
+        return NULL;
+    if (multi_init(&s->c, channels, rate, options) != 0)
+    {
+        free(s);
+        return NULL;
+    }
+    s->lanes = decode_block_generic;
+#if defined(G722_CPU_AVX)
+    if (g722_cpu_has_avx512f())
+        s->lanes = decode_block_avx512;
+    else if (g722_cpu_has_avx2())
+        s->lanes = decode_block_avx2;
+#endif
+    return s;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_multi_decoder_destroy(G722_MDEC_CTX *s)
+{
+    free(s->c.mem);
+    free(s);
+    return 0;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_multi_decode(G722_MDEC_CTX *s, const uint8_t * const g722_data[], int len, int16_t * const amp[])
+{
+    struct g722_multi_common *c;
+    struct g722_lane_block *blk;
+    int16_t xbuf[G722_QMF_HIST + 2*G722_MULTI_BLOCK];
+    struct g722_multi_bits *bits;
+    const uint8_t *in;
+    int16_t *out;
+    int outlen;
+    int codes;
+    int step;
+    int lane;
+    int ch;
+    int j;
+    int n;
+    int g;
+    int k;
+
+    c = &s->c;
+    blk = c->block;
+    /* Packed bytes hold more than one code, and up to 7 leftover bits come
+       in from the last call, so take few enough bytes to fit in a block */
+    step = (c->packed)  ?  (G722_MULTI_BLOCK*c->bits_per_sample - 7)/8  :  G722_MULTI_BLOCK;
+    outlen = 0;
+    for (g = 0;  g < c->groups;  g++)
+    {
+        outlen = 0;
+        for (j = 0;  j < len;  j += n)
+        {
+            /* Every channel unpacks the same number of codes from n bytes */
+            n = len - j;
+            if (n > step)
+                n = step;
+            codes = 0;
+            for (lane = 0;  lane < G722_MULTI_GROUP;  lane++)
+            {
+                ch = g*G722_MULTI_GROUP + lane;
+                if (ch >= c->channels)
+                {
+                    for (k = 0;  k < codes;  k++)
+                        blk->code[k][lane] = 0;
+                    continue;
+                }
+                in = g722_data[ch] + j;
+                if (!c->packed)
+                {
+                    for (k = 0;  k < n;  k++)
+                        blk->code[k][lane] = in[k];
+                    codes = n;
+                    continue;
+                }
+                bits = &c->bits[ch];
+                codes = 0;
+                for (k = 0;  k < n;  )
+                {
+                    /* Unpack the code bits */
+                    if (bits->bits < c->bits_per_sample)
+                    {
+                        bits->buffer |= (in[k++] << bits->bits);
+                        bits->bits += 8;
+                    }
+                    blk->code[codes++][lane] = bits->buffer & ((1 << c->bits_per_sample) - 1);
+                    bits->buffer >>= c->bits_per_sample;
+                    bits->bits -= c->bits_per_sample;
+                }
+            }
+
+            s->lanes(&c->group[g], (const int32_t (*)[G722_MULTI_GROUP]) blk->code, codes, blk->x,
+                     c->eight_k, c->bits_per_sample);
+
+            for (lane = 0;  lane < G722_MULTI_GROUP;  lane++)
+            {
+                ch = g*G722_MULTI_GROUP + lane;
+                if (ch >= c->channels)
+                    break;
+                out = amp[ch] + outlen;
+                if (c->eight_k)
+                {
+                    for (k = 0;  k < codes;  k++)
+                        out[k] = (int16_t) blk->x[k][0][lane];
+                    continue;
+                }
+                /* Apply the receive QMF */
+                memcpy(xbuf, c->x[ch], sizeof(c->x[ch]));
+                for (k = 0;  k < codes;  k++)
+                {
+                    xbuf[G722_QMF_HIST + 2*k] = (int16_t) blk->x[k][0][lane];
+                    xbuf[G722_QMF_HIST + 2*k + 1] = (int16_t) blk->x[k][1][lane];
+                }
+                c->qmf(xbuf, codes, 11, &g722_qmf_rx_taps, out);
+                memcpy(c->x[ch], xbuf + 2*codes, sizeof(c->x[ch]));
+            }
+            outlen += (c->eight_k)  ?  codes  :  2*codes;
+        }
+    }
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
@@ -0,0 +1,56 @@
+/*
+ * g722_multi.h - The ITU G.722 codec, multi-channel encoder and decoder.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ */
+
+
+/*! \file */
+
+#pragma once
+
+#include "g722.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \page g722_multi_page Multi-channel G.722 encoding and decoding
+\section g722_multi_page_sec_1 What does it do?
+The ADPCM part of G.722 is a serial recursion within one stream, but it is the
+same recursion for every stream. The multi-channel encoder and decoder keep
+the state of many independent channels side by side, and advance all of them
+together, one channel per SIMD lane (AVX-512 or AVX2 where available). The
+output of every channel is bit exact with that of a separate G722_ENC_CTX or
+G722_DEC_CTX created with the same rate and options.
+
+All channels share the rate and options, and are coded in lockstep, with the
+same number of samples or bytes per call.
+*/
+
+typedef struct g722_multi_encode_state G722_MENC_CTX;
+typedef struct g722_multi_decode_state G722_MDEC_CTX;
+
+G722_MENC_CTX *g722_multi_encoder_new(int channels, int rate, int options);
+int g722_multi_encoder_destroy(G722_MENC_CTX *s);
+/*! Encode len samples of each channel.
+    \param s The multi-channel encoder context.
+    \param amp One array of len samples per channel.
+    \param len The number of samples per channel.
+    \param g722_data One output array per channel.
+    \return The number of bytes written to each of the output arrays. */
+int g722_multi_encode(G722_MENC_CTX *s, const int16_t * const amp[], int len, uint8_t * const g722_data[]);
+
+G722_MDEC_CTX *g722_multi_decoder_new(int channels, int rate, int options);
+int g722_multi_decoder_destroy(G722_MDEC_CTX *s);
+/*! Decode len bytes of each channel.
+    \param s The multi-channel decoder context.
+    \param g722_data One array of len bytes per channel.
+    \param len The number of bytes per channel.
+    \param amp One output array per channel.
+    \return The number of samples written to each of the output arrays. */
+int g722_multi_decode(G722_MDEC_CTX *s, const uint8_t * const g722_data[], int len, int16_t * const amp[]);
+
+#ifdef __cplusplus
+}
+#endif
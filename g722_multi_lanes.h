@@ -0,0 +1,281 @@
+/*
+ * g722_multi_lanes.h - The ITU G.722 codec, lane parallel ADPCM.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  This is a template, included once per vector flavour by g722_multi.c,
+ *  after defining LANES_W, LANES_FN(), LANES_TARGET, the vector (VT) and
+ *  mask (MT) types, and the V_*() operations on 32 bit lanes. Each lane
+ *  runs exactly the integer arithmetic of g722_encode()/g722_decode() for
+ *  its own channel, with the data dependent branches turned into selects.
+ */
+
+/*! \file */
+
+#define V_SAT(v) V_MIN(V_MAX(v, V_SET1(INT16_MIN)), V_SET1(INT16_MAX))
+#define V_CLAMP(v, lo, hi) V_MIN(V_MAX(v, V_SET1(lo)), V_SET1(hi))
+#define V_ZERO V_SET1(0)
+
+static inline void LANES_TARGET LANES_FN(block4)(struct g722_lane_band *band, int o, VT d)
+{
+    VT r0;
+    VT r1;
+    VT p0;
+    VT p1;
+    VT a1;
+    VT a2;
+    VT ap1;
+    VT ap2;
+    VT sg0;
+    VT sgd;
+    VT dd[7];
+    VT bp;
+    VT wd1;
+    VT wd2;
+    VT wd3;
+    VT sz;
+    MT same01;
+    int i;
+
+    /* Block 4, RECONS */
+    r0 = V_SAT(V_ADD(V_LOAD(band->s + o), d));
+
+    /* Block 4, PARREC */
+    p0 = V_SAT(V_ADD(V_LOAD(band->sz + o), d));
+    p1 = V_LOAD(band->p[1] + o);
+
+    /* Block 4, UPPOL2 */
+    a1 = V_LOAD(band->a[1] + o);
+    a2 = V_LOAD(band->a[2] + o);
+    sg0 = V_SRAI(p0, 15);
+    same01 = V_CMPEQ(sg0, V_SRAI(p1, 15));
+    wd1 = V_SAT(V_SLLI(a1, 2));
+    wd2 = V_SEL(same01, V_SUB(V_ZERO, wd1), wd1);
+    wd2 = V_MIN(wd2, V_SET1(32767));
+    wd3 = V_ADD(V_SRAI(wd2, 7), V_SEL(V_CMPEQ(sg0, V_SRAI(V_LOAD(band->p[2] + o), 15)), V_SET1(128), V_SET1(-128)));
+    wd3 = V_ADD(wd3, V_SRAI(V_MUL(a2, V_SET1(32512)), 15));
+    ap2 = V_CLAMP(wd3, -12288, 12288);
+
+    /* Block 4, UPPOL1. As in block4_bands(), neither sum here can saturate. */
+    wd1 = V_SEL(same01, V_SET1(192), V_SET1(-192));
+    wd2 = V_SRAI(V_MUL(a1, V_SET1(32640)), 15);
+    ap1 = V_ADD(wd1, wd2);
+    wd3 = V_SUB(V_SET1(15360), ap2);
+    ap1 = V_MIN(V_MAX(ap1, V_SUB(V_ZERO, wd3)), wd3);
+
+    /* Block 4, UPZERO and DELAYA */
+    wd1 = V_SEL(V_CMPEQ(d, V_ZERO), V_ZERO, V_SET1(128));
+    sgd = V_SRAI(d, 15);
+    dd[0] = d;
+    for (i = 1;  i < 7;  i++)
+        dd[i] = V_LOAD(band->d[i] + o);
+    sz = V_ZERO;
+    for (i = 1;  i < 7;  i++)
+    {
+        wd2 = V_SEL(V_CMPEQ(V_SRAI(dd[i], 15), sgd), wd1, V_SUB(V_ZERO, wd1));
+        wd3 = V_SRAI(V_MUL(V_LOAD(band->b[i] + o), V_SET1(32640)), 15);
+        bp = V_ADD(wd2, wd3);
+        V_STORE(band->b[i] + o, bp);
+        V_STORE(band->d[i] + o, dd[i - 1]);
+
+        /* Block 4, FILTEZ */
+        sz = V_ADD(sz, V_SRAI(V_MUL(bp, V_ADD(dd[i - 1], dd[i - 1])), 15));
+    }
+    sz = V_SAT(sz);
+    r1 = V_LOAD(band->r[1] + o);
+    V_STORE(band->r[2] + o, r1);
+    V_STORE(band->r[1] + o, r0);
+    V_STORE(band->p[2] + o, p1);
+    V_STORE(band->p[1] + o, p0);
+    V_STORE(band->a[2] + o, ap2);
+    V_STORE(band->a[1] + o, ap1);
+
+    /* Block 4, FILTEP */
+    wd1 = V_SRAI(V_MUL(ap1, V_SAT(V_ADD(r0, r0))), 15);
+    wd2 = V_SRAI(V_MUL(ap2, V_SAT(V_ADD(r1, r1))), 15);
+
+    /* Block 4, PREDIC */
+    V_STORE(band->sz + o, sz);
+    V_STORE(band->s + o, V_SAT(V_ADD(V_SAT(V_ADD(wd1, wd2)), sz)));
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Blocks 3L/3H, LOGSCL/LOGSCH and SCALEL/SCALEH. The variable direction
+   shift of ilb[] is folded into a single right shift of ilb[] << 1. */
+static inline void LANES_TARGET LANES_FN(adapt)(struct g722_lane_band *band, int o, VT wl, int nb_max, int shift)
+{
+    VT nb;
+    VT wd;
+
+    nb = V_ADD(V_SRAI(V_MUL(V_LOAD(band->nb + o), V_SET1(127)), 7), wl);
+    nb = V_CLAMP(nb, 0, nb_max);
+    V_STORE(band->nb + o, nb);
+    wd = V_SLLI(V_GATHER(lane_ilb, V_AND(V_SRAI(nb, 6), V_SET1(31))), 1);
+    wd = V_SRAV(wd, V_SUB(V_SET1(shift + 1), V_SRAI(nb, 11)));
+    V_STORE(band->det + o, V_SLLI(wd, 2));
+}
+/*- End of function --------------------------------------------------------*/
+
+static void LANES_TARGET LANES_FN(encode_block)(struct g722_lane_group *g, const int32_t x[][2][G722_MULTI_GROUP],
+  int n, int32_t code[][G722_MULTI_GROUP], int eight_k, int shift)
+{
+    struct g722_lane_band *lo;
+    struct g722_lane_band *hi;
+    VT el;
+    VT eh;
+    VT wd;
+    VT det;
+    VT ilow;
+    VT ihigh;
+    VT ril;
+    VT cnt;
+    MT neg;
+    MT big;
+    int o;
+    int i;
+    int k;
+
+    lo = &g->band[0];
+    hi = &g->band[1];
+    for (o = 0;  o < G722_MULTI_GROUP;  o += LANES_W)
+    {
+        for (k = 0;  k < n;  k++)
+        {
+            /* Block 1L, SUBTRA */
+            el = V_SAT(V_SUB(V_LOAD(x[k][0] + o), V_LOAD(lo->s + o)));
+
+            /* Block 1L, QUANTL. The thresholds grow with i, so the index of
+               the first one above wd is one plus the count of those below. */
+            wd = V_XOR(el, V_SRAI(el, 31));
+            det = V_LOAD(lo->det + o);
+            cnt = V_SET1(1);
+            for (i = 1;  i < 30;  i++)
+                cnt = V_ADD(cnt, V_SEL(V_CMPGT(V_SRAI(V_MUL(V_SET1(lane_q6[i]), det), 12), wd), V_ZERO, V_SET1(1)));
+            /* ilp[i] is 62 - i, iln[i] is 64 - i for i < 3, and 34 - i above */
+            neg = V_CMPGT(V_ZERO, el);
+            ilow = V_SUB(V_SEL(neg, V_SEL(V_CMPGT(cnt, V_SET1(2)), V_SET1(34), V_SET1(64)), V_SET1(62)), cnt);
+
+            /* Block 2L, INVQAL */
+            ril = V_SRAI(ilow, 2);
+            wd = V_SRAI(V_MUL(det, V_GATHER(lane_qm4, ril)), 15);
+
+            LANES_FN(adapt)(lo, o, V_GATHER(lane_wl_rl42, ril), 18432, 8);
+            LANES_FN(block4)(lo, o, wd);
+
+            if (eight_k)
+            {
+                /* Just leave the high bits as zero */
+                V_STORE(code[k] + o, V_SRAV(V_ADD(ilow, V_SET1(0xC0)), V_SET1(shift)));
+                continue;
+            }
+
+            /* Block 1H, SUBTRA */
+            eh = V_SAT(V_SUB(V_LOAD(x[k][1] + o), V_LOAD(hi->s + o)));
+
+            /* Block 1H, QUANTH */
+            wd = V_XOR(eh, V_SRAI(eh, 31));
+            det = V_LOAD(hi->det + o);
+            big = V_CMPGT(V_SRAI(V_MUL(V_SET1(564), det), 12), wd);
+            neg = V_CMPGT(V_ZERO, eh);
+            /* ihn[] and ihp[], with big meaning mih == 1 */
+            ihigh = V_SEL(neg, V_SEL(big, V_SET1(1), V_ZERO), V_SEL(big, V_SET1(3), V_SET1(2)));
+
+            /* Block 2H, INVQAH */
+            wd = V_SRAI(V_MUL(det, V_GATHER(lane_qm2, ihigh)), 15);
+
+            LANES_FN(adapt)(hi, o, V_SEL(big, V_SET1(-214), V_SET1(798)), 22528, 10);
+            LANES_FN(block4)(hi, o, wd);
+            V_STORE(code[k] + o, V_SRAV(V_ADD(V_SLLI(ihigh, 6), ilow), V_SET1(shift)));
+        }
+    }
+}
+/*- End of function --------------------------------------------------------*/
+
+static void LANES_TARGET LANES_FN(decode_block)(struct g722_lane_group *g, const int32_t code[][G722_MULTI_GROUP],
+  int n, int32_t x[][2][G722_MULTI_GROUP], int eight_k, int bits_per_sample)
+{
+    struct g722_lane_band *lo;
+    struct g722_lane_band *hi;
+    const int32_t *qmx;
+    VT c;
+    VT wd1;
+    VT wd2;
+    VT det;
+    VT ihigh;
+    VT rlow;
+    VT rhigh;
+    int low_mask;
+    int low_shift;
+    int o;
+    int k;
+
+    /* The low band bits of the code, and how far they are from being 4 bits */
+    switch (bits_per_sample)
+    {
+    default:
+    case 8:
+        qmx = lane_qm6;
+        low_mask = 0x3F;
+        low_shift = 2;
+        break;
+    case 7:
+        qmx = lane_qm5;
+        low_mask = 0x1F;
+        low_shift = 1;
+        break;
+    case 6:
+        qmx = lane_qm4;
+        low_mask = 0x0F;
+        low_shift = 0;
+        break;
+    }
+    lo = &g->band[0];
+    hi = &g->band[1];
+    for (o = 0;  o < G722_MULTI_GROUP;  o += LANES_W)
+    {
+        for (k = 0;  k < n;  k++)
+        {
+            c = V_LOAD(code[k] + o);
+            wd1 = V_AND(c, V_SET1(low_mask));
+            ihigh = V_AND(V_SRAV(c, V_SET1(bits_per_sample - 2)), V_SET1(0x03));
+            det = V_LOAD(lo->det + o);
+
+            /* Block 5L, LOW BAND INVQBL */
+            wd2 = V_SRAI(V_MUL(det, V_GATHER(qmx, wd1)), 15);
+            /* Block 5L, RECONS and Block 6L, LIMIT */
+            rlow = V_CLAMP(V_ADD(V_LOAD(lo->s + o), wd2), -16384, 16383);
+
+            /* Block 2L, INVQAL */
+            wd1 = V_SRAV(wd1, V_SET1(low_shift));
+            wd2 = V_SRAI(V_MUL(det, V_GATHER(lane_qm4, wd1)), 15);
+
+            LANES_FN(adapt)(lo, o, V_GATHER(lane_wl_rl42, wd1), 18432, 8);
+            LANES_FN(block4)(lo, o, wd2);
+
+            if (eight_k)
+            {
+                V_STORE(x[k][0] + o, V_SLLI(rlow, 1));
+                continue;
+            }
+
+            /* Block 2H, INVQAH */
+            det = V_LOAD(hi->det + o);
+            wd2 = V_SRAI(V_MUL(det, V_GATHER(lane_qm2, ihigh)), 15);
+            /* Block 5H, RECONS and Block 6H, LIMIT */
+            rhigh = V_CLAMP(V_ADD(V_LOAD(hi->s + o), wd2), -16384, 16383);
+
+            LANES_FN(adapt)(hi, o, V_GATHER(lane_wh_rh2, ihigh), 22528, 10);
+            LANES_FN(block4)(hi, o, wd2);
+
+            /* The receive QMF input */
+            V_STORE(x[k][0] + o, V_ADD(rlow, rhigh));
+            V_STORE(x[k][1] + o, V_SUB(rlow, rhigh));
+        }
+    }
+}
+/*- End of function --------------------------------------------------------*/
+
+#undef V_SAT
+#undef V_CLAMP
+#undef V_ZERO
+/*- End of file ------------------------------------------------------------*/
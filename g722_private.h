@@ -22,6 +22,10 @@
 
 #pragma once
 
+#include "g722_qmf.h"
+#include "g722_resample.h"
+#include "g722.h"
+
 /*! \page g722_page G.722 encoding and decoding
 \section g722_page_sec_1 What does it do?
 The G.722 module is a bit exact implementation of the ITU G.722 specification for all three
@@ -40,65 +44,129 @@ typedef struct g722_encode_state G722_ENC_CTX;
 typedef struct g722_decode_state G722_DEC_CTX;
 #define _G722_DEC_CTX_DEFINED
 
+/*! A complete encoder or decoder loop, specialised for one combination of modes */
+typedef int (*g722_encode_fn)(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t g722_data[]);
+typedef int (*g722_decode_fn)(G722_DEC_CTX *s, const uint8_t g722_data[], int len, int16_t amp[]);
+
+/*! The number of repeats of a code the decoder waits for before checking
+    if the code has settled, enough to fill the QMF history with its output */
+#define G722_IDLE_RUN (G722_QMF_HIST/2 + 1)
+
+/*! The adaptive predictor and scale factor state of one band. Every value
+    is saturated or limited to 16 bits by the spec. */
 struct g722_band
 {
-    int s;
-    int sp;
-    int sz;
-    int r[3];
-    int a[3];
-    int ap[3];
-    int p[3];
-    int d[7];
-    int b[7];
-    int bp[7];
-    int sg[7];
-    int nb;
-    int det;
+    int16_t s;
+    int16_t sz;
+    int16_t r[3];
+    int16_t a[3];
+    int16_t p[3];
+    int16_t d[7];
+    int16_t b[7];
+    int16_t nb;
+    int16_t det;
+};
+
+/*! The decimator state of an encoder set up with G722_RESAMPLE_48000 */
+struct g722_encode_rs
+{
+    /*! 48k signal history */
+    int16_t hist[G722_RS_HIST];
+    /*! 48k samples since the last output */
+    uint8_t phase;
+    /*! TRUE if odd is a decimated sample still waiting for its pair */
+    uint8_t pending;
+    int16_t odd;
+};
+
+/*! The interpolator state of a decoder set up with G722_RESAMPLE_48000 */
+struct g722_decode_rs
+{
+    /*! Low rate signal history */
+    int16_t hist[G722_RS_UP_HIST];
 };
 
 struct g722_encode_state
 {
+    /*! The encoder loop for the modes below */
+    g722_encode_fn encode;
+    /*! The QMF kernel for this CPU */
+    g722_qmf_fn qmf;
+
     /*! TRUE if the operating in the special ITU test mode, with the band split filters
              disabled. */
-    int itu_test_mode;
+    uint8_t itu_test_mode;
     /*! TRUE if the G.722 data is packed */
-    int packed;
+    uint8_t packed;
     /*! TRUE if encode from 8k samples/second */
-    int eight_k;
+    uint8_t eight_k;
     /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
-    int bits_per_sample;
+    uint8_t bits_per_sample;
+    /*! TRUE if set up for 48k samples/second, with rs there */
+    uint8_t rs48k;
 
-    /*! Signal history for the QMF */
-    int x[24];
+    /*! Code bits not yet written out, when packing */
+    uint16_t out_buffer;
+    uint8_t out_bits;
 
     struct g722_band band[2];
 
-    unsigned int in_buffer;
-    int in_bits;
-    unsigned int out_buffer;
-    int out_bits;
+    /*! Signal history for the QMF */
+    int16_t x[G722_QMF_HIST];
+
+    /*! TRUE if digital silence is known to leave the high band state as it
+        is, with idle_ihigh as its code */
+    uint8_t high_idle;
+    uint8_t idle_ihigh;
+
+#if defined(G722_ENABLE_STATS)
+    struct g722_stats stats;
+#endif
+
+    /*! The decimator for g722_encode_48khz(), which only a context set up
+        for it has room for, out of the way of the state every call uses */
+    struct g722_encode_rs rs[];
 };
 
 struct g722_decode_state
 {
+    /*! The decoder loop for the modes below */
+    g722_decode_fn decode;
+    /*! The QMF kernel for this CPU */
+    g722_qmf_fn qmf;
+
     /*! TRUE if the operating in the special ITU test mode, with the band split filters
              disabled. */
-    int itu_test_mode;
+    uint8_t itu_test_mode;
     /*! TRUE if the G.722 data is packed */
-    int packed;
+    uint8_t packed;
     /*! TRUE if decode to 8k samples/second */
-    int eight_k;
+    uint8_t eight_k;
     /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
-    int bits_per_sample;
+    uint8_t bits_per_sample;
+    /*! TRUE if set up for 48k samples/second, with rs there */
+    uint8_t rs48k;
 
-    /*! Signal history for the QMF */
-    int x[24];
+    /*! Code bits not yet used, when unpacking */
+    uint16_t in_buffer;
+    uint8_t in_bits;
 
     struct g722_band band[2];
-    
-    unsigned int in_buffer;
-    int in_bits;
-    unsigned int out_buffer;
-    int out_bits;
+
+    /*! Signal history for the QMF */
+    int16_t x[G722_QMF_HIST];
+
+    /*! TRUE if idle_code is known to leave the state, and the QMF history,
+        as they are, with idle_out as its output */
+    uint8_t idle;
+    uint8_t idle_code;
+    int16_t idle_out[2];
+
+#if defined(G722_ENABLE_STATS)
+    struct g722_stats stats;
+#endif
+
+    /*! The interpolator for g722_decode_48khz(), which only a context set
+        up for it has room for, out of the way of the state every call uses */
+    struct g722_decode_rs rs[];
 };
@@ -0,0 +1,360 @@
+/*
+ * g722_qmf.c - The ITU G.722 codec, block QMF kernels.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  Both QMFs are pairs of 24-tap dot products of 16-bit samples with 16-bit
+ *  coefficients, which is exactly what pmaddwd (SSE2/AVX2) and vmlal (NEON)
+ *  compute. The results are bit exact with the scalar filters, since no
+ *  partial sum can overflow 32 bits.
+ */
+
+/*! \file */
+
+#include <stdint.h>
+
+#include "g722_private.h"
+#include "g722_common.h"
+#include "g722_cpu.h"
+
+#if defined(G722_ENABLE_STATS)
+G722_THREAD_LOCAL struct g722_tally g722_tally;
+
+/* The number of bits set in a lane mask */
+static inline int mask_bits(int m)
+{
+    int n;
+
+    for (n = 0;  m;  n++)
+        m &= m - 1;
+    return n;
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+/* The 12 QMF coefficients, spread so each pair output is a plain 24-tap dot
+   product with the 24 most recent signal samples. */
+#define QMF_C0    3
+#define QMF_C1  -11
+#define QMF_C2   12
+#define QMF_C3   32
+#define QMF_C4 -210
+#define QMF_C5  951
+#define QMF_C6 3876
+#define QMF_C7 -805
+#define QMF_C8  362
+#define QMF_C9 -156
+#define QMF_C10  53
+#define QMF_C11 -11
+
+/* xlow = (sumeven + sumodd) >> 14, xhigh = (sumeven - sumodd) >> 14 */
+const struct g722_qmf_taps g722_qmf_tx_taps =
+{
+    {
+        {
+             QMF_C0, QMF_C11,  QMF_C1, QMF_C10,  QMF_C2,  QMF_C9,
+             QMF_C3,  QMF_C8,  QMF_C4,  QMF_C7,  QMF_C5,  QMF_C6,
+             QMF_C6,  QMF_C5,  QMF_C7,  QMF_C4,  QMF_C8,  QMF_C3,
+             QMF_C9,  QMF_C2, QMF_C10,  QMF_C1, QMF_C11,  QMF_C0
+        },
+        {
+            -QMF_C0, QMF_C11, -QMF_C1, QMF_C10, -QMF_C2,  QMF_C9,
+            -QMF_C3,  QMF_C8, -QMF_C4,  QMF_C7, -QMF_C5,  QMF_C6,
+            -QMF_C6,  QMF_C5, -QMF_C7,  QMF_C4, -QMF_C8,  QMF_C3,
+            -QMF_C9,  QMF_C2,-QMF_C10,  QMF_C1,-QMF_C11,  QMF_C0
+        }
+    }
+};
+
+/* xout1 from the odd taps, xout2 from the even ones, both >> 11 */
+const struct g722_qmf_taps g722_qmf_rx_taps =
+{
+    {
+        {
+                  0, QMF_C11,       0, QMF_C10,       0,  QMF_C9,
+                  0,  QMF_C8,       0,  QMF_C7,       0,  QMF_C6,
+                  0,  QMF_C5,       0,  QMF_C4,       0,  QMF_C3,
+                  0,  QMF_C2,       0,  QMF_C1,       0,  QMF_C0
+        },
+        {
+             QMF_C0,       0,  QMF_C1,       0,  QMF_C2,       0,
+             QMF_C3,       0,  QMF_C4,       0,  QMF_C5,       0,
+             QMF_C6,       0,  QMF_C7,       0,  QMF_C8,       0,
+             QMF_C9,       0, QMF_C10,       0, QMF_C11,       0
+        }
+    }
+};
+
+static inline void qmf_pair(const int16_t x[], int shift, const struct g722_qmf_taps *taps, int16_t out[])
+{
+    int32_t sum0;
+    int32_t sum1;
+    int i;
+
+    sum0 = 0;
+    sum1 = 0;
+    for (i = 0;  i < 24;  i++)
+    {
+        sum0 += x[i]*taps->c[0][i];
+        sum1 += x[i]*taps->c[1][i];
+    }
+    out[0] = saturate(sum0 >> shift);
+    out[1] = saturate(sum1 >> shift);
+}
+/*- End of function --------------------------------------------------------*/
+
+static void qmf_scalar(const int16_t x[], int pairs, int shift, const struct g722_qmf_taps *taps, int16_t out[])
+{
+    int k;
+
+    for (k = 0;  k < pairs;  k++)
+        qmf_pair(x + 2*k, shift, taps, out + 2*k);
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(G722_CPU_X86)
+#if defined(G722_ENABLE_STATS)
+/* Tally the lanes of shifted sums that packs will saturate */
+static inline void G722_TARGET_SSE2 tally_clips_sse2(__m128i v)
+{
+    __m128i over;
+
+    over = _mm_or_si128(_mm_cmpgt_epi32(v, _mm_set1_epi32(INT16_MAX)),
+                        _mm_cmplt_epi32(v, _mm_set1_epi32(INT16_MIN)));
+    g722_tally.saturations += mask_bits(_mm_movemask_ps(_mm_castsi128_ps(over)));
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+/* Sum each of the four vectors horizontally, giving one lane per vector */
+static inline __m128i G722_TARGET_SSE2 hsum4_sse2(__m128i v0, __m128i v1, __m128i v2, __m128i v3)
+{
+    __m128i t0;
+    __m128i t1;
+
+    t0 = _mm_add_epi32(_mm_unpacklo_epi32(v0, v1), _mm_unpackhi_epi32(v0, v1));
+    t1 = _mm_add_epi32(_mm_unpacklo_epi32(v2, v3), _mm_unpackhi_epi32(v2, v3));
+    return _mm_add_epi32(_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1));
+}
+/*- End of function --------------------------------------------------------*/
+
+static inline __m128i G722_TARGET_SSE2 dot24_sse2(const int16_t x[], __m128i c0, __m128i c1, __m128i c2)
+{
+    __m128i sum;
+
+    sum = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) x), c0);
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (x + 8)), c1));
+    return _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (x + 16)), c2));
+}
+/*- End of function --------------------------------------------------------*/
+
+static void G722_TARGET_SSE2 qmf_sse2(const int16_t x[], int pairs, int shift, const struct g722_qmf_taps *taps, int16_t out[])
+{
+    __m128i a0;
+    __m128i a1;
+    __m128i a2;
+    __m128i b0;
+    __m128i b1;
+    __m128i b2;
+    __m128i sh;
+    __m128i sum0;
+    __m128i sum1;
+    int k;
+
+    a0 = _mm_loadu_si128((const __m128i *) taps->c[0]);
+    a1 = _mm_loadu_si128((const __m128i *) (taps->c[0] + 8));
+    a2 = _mm_loadu_si128((const __m128i *) (taps->c[0] + 16));
+    b0 = _mm_loadu_si128((const __m128i *) taps->c[1]);
+    b1 = _mm_loadu_si128((const __m128i *) (taps->c[1] + 8));
+    b2 = _mm_loadu_si128((const __m128i *) (taps->c[1] + 16));
+    sh = _mm_cvtsi32_si128(shift);
+    for (k = 0;  k + 4 <= pairs;  k += 4)
+    {
+        sum0 = hsum4_sse2(dot24_sse2(x + 2*k, a0, a1, a2),
+                          dot24_sse2(x + 2*k + 2, a0, a1, a2),
+                          dot24_sse2(x + 2*k + 4, a0, a1, a2),
+                          dot24_sse2(x + 2*k + 6, a0, a1, a2));
+        sum1 = hsum4_sse2(dot24_sse2(x + 2*k, b0, b1, b2),
+                          dot24_sse2(x + 2*k + 2, b0, b1, b2),
+                          dot24_sse2(x + 2*k + 4, b0, b1, b2),
+                          dot24_sse2(x + 2*k + 6, b0, b1, b2));
+        sum0 = _mm_sra_epi32(sum0, sh);
+        sum1 = _mm_sra_epi32(sum1, sh);
+        G722_STATS(tally_clips_sse2(sum0));
+        G722_STATS(tally_clips_sse2(sum1));
+        /* packs saturates exactly like saturate() */
+        _mm_storeu_si128((__m128i *) (out + 2*k),
+                         _mm_packs_epi32(_mm_unpacklo_epi32(sum0, sum1), _mm_unpackhi_epi32(sum0, sum1)));
+    }
+    for (  ;  k < pairs;  k++)
+        qmf_pair(x + 2*k, shift, taps, out + 2*k);
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(G722_CPU_AVX)
+/* The window of pair k in the low lane, and that of pair k + 1 in the high one */
+static inline __m256i G722_TARGET("avx2") dot24x2_avx2(const int16_t x[], __m256i c0, __m256i c1, __m256i c2)
+{
+    __m256i sum;
+    __m256i w;
+
+    w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) x)),
+                                _mm_loadu_si128((const __m128i *) (x + 2)), 1);
+    sum = _mm256_madd_epi16(w, c0);
+    w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (x + 8))),
+                                _mm_loadu_si128((const __m128i *) (x + 10)), 1);
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(w, c1));
+    w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (x + 16))),
+                                _mm_loadu_si128((const __m128i *) (x + 18)), 1);
+    return _mm256_add_epi32(sum, _mm256_madd_epi16(w, c2));
+}
+/*- End of function --------------------------------------------------------*/
+
+#if defined(G722_ENABLE_STATS)
+static inline void G722_TARGET("avx2") tally_clips_avx2(__m256i v)
+{
+    __m256i over;
+
+    over = _mm256_or_si256(_mm256_cmpgt_epi32(v, _mm256_set1_epi32(INT16_MAX)),
+                           _mm256_cmpgt_epi32(_mm256_set1_epi32(INT16_MIN), v));
+    g722_tally.saturations += mask_bits(_mm256_movemask_ps(_mm256_castsi256_ps(over)));
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+/* Lane 0 gets pairs 0, 2, 4, 6, lane 1 gets pairs 1, 3, 5, 7 */
+static inline __m256i G722_TARGET("avx2") hsum8_avx2(__m256i v01, __m256i v23, __m256i v45, __m256i v67)
+{
+    __m256i t0;
+    __m256i t1;
+
+    t0 = _mm256_add_epi32(_mm256_unpacklo_epi32(v01, v23), _mm256_unpackhi_epi32(v01, v23));
+    t1 = _mm256_add_epi32(_mm256_unpacklo_epi32(v45, v67), _mm256_unpackhi_epi32(v45, v67));
+    return _mm256_add_epi32(_mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1));
+}
+/*- End of function --------------------------------------------------------*/
+
+static void G722_TARGET("avx2") qmf_avx2(const int16_t x[], int pairs, int shift, const struct g722_qmf_taps *taps, int16_t out[])
+{
+    __m256i a0;
+    __m256i a1;
+    __m256i a2;
+    __m256i b0;
+    __m256i b1;
+    __m256i b2;
+    __m256i order;
+    __m128i sh;
+    __m256i sum0;
+    __m256i sum1;
+    __m256i res;
+    int k;
+
+    a0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) taps->c[0]));
+    a1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) (taps->c[0] + 8)));
+    a2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) (taps->c[0] + 16)));
+    b0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) taps->c[1]));
+    b1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) (taps->c[1] + 8)));
+    b2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) (taps->c[1] + 16)));
+    order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    sh = _mm_cvtsi32_si128(shift);
+    for (k = 0;  k + 8 <= pairs;  k += 8)
+    {
+        sum0 = hsum8_avx2(dot24x2_avx2(x + 2*k, a0, a1, a2),
+                          dot24x2_avx2(x + 2*k + 4, a0, a1, a2),
+                          dot24x2_avx2(x + 2*k + 8, a0, a1, a2),
+                          dot24x2_avx2(x + 2*k + 12, a0, a1, a2));
+        sum1 = hsum8_avx2(dot24x2_avx2(x + 2*k, b0, b1, b2),
+                          dot24x2_avx2(x + 2*k + 4, b0, b1, b2),
+                          dot24x2_avx2(x + 2*k + 8, b0, b1, b2),
+                          dot24x2_avx2(x + 2*k + 12, b0, b1, b2));
+        sum0 = _mm256_sra_epi32(sum0, sh);
+        sum1 = _mm256_sra_epi32(sum1, sh);
+        G722_STATS(tally_clips_avx2(sum0));
+        G722_STATS(tally_clips_avx2(sum1));
+        /* Each 32 bit unit now holds one saturated output pair, in the
+           order 0, 2, 4, 6, 1, 3, 5, 7 */
+        res = _mm256_packs_epi32(_mm256_unpacklo_epi32(sum0, sum1), _mm256_unpackhi_epi32(sum0, sum1));
+        res = _mm256_permutevar8x32_epi32(res, order);
+        _mm256_storeu_si256((__m256i *) (out + 2*k), res);
+    }
+    if (k < pairs)
+        qmf_sse2(x + 2*k, pairs - k, shift, taps, out + 2*k);
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+#endif
+
+#if defined(G722_CPU_NEON)
+static void qmf_neon(const int16_t x[], int pairs, int shift, const struct g722_qmf_taps *taps, int16_t out[])
+{
+    int16x8_t a0;
+    int16x8_t a1;
+    int16x8_t a2;
+    int16x8_t b0;
+    int16x8_t b1;
+    int16x8_t b2;
+    int16x8_t w0;
+    int16x8_t w1;
+    int16x8_t w2;
+    int32x4_t sum0;
+    int32x4_t sum1;
+    int32x2_t res;
+    int32x2_t sh;
+    int16x4_t res16;
+    int k;
+
+    a0 = vld1q_s16(taps->c[0]);
+    a1 = vld1q_s16(taps->c[0] + 8);
+    a2 = vld1q_s16(taps->c[0] + 16);
+    b0 = vld1q_s16(taps->c[1]);
+    b1 = vld1q_s16(taps->c[1] + 8);
+    b2 = vld1q_s16(taps->c[1] + 16);
+    sh = vdup_n_s32(-shift);
+    for (k = 0;  k < pairs;  k++)
+    {
+        w0 = vld1q_s16(x + 2*k);
+        w1 = vld1q_s16(x + 2*k + 8);
+        w2 = vld1q_s16(x + 2*k + 16);
+        sum0 = vmull_s16(vget_low_s16(w0), vget_low_s16(a0));
+        sum0 = vmlal_s16(sum0, vget_high_s16(w0), vget_high_s16(a0));
+        sum0 = vmlal_s16(sum0, vget_low_s16(w1), vget_low_s16(a1));
+        sum0 = vmlal_s16(sum0, vget_high_s16(w1), vget_high_s16(a1));
+        sum0 = vmlal_s16(sum0, vget_low_s16(w2), vget_low_s16(a2));
+        sum0 = vmlal_s16(sum0, vget_high_s16(w2), vget_high_s16(a2));
+        sum1 = vmull_s16(vget_low_s16(w0), vget_low_s16(b0));
+        sum1 = vmlal_s16(sum1, vget_high_s16(w0), vget_high_s16(b0));
+        sum1 = vmlal_s16(sum1, vget_low_s16(w1), vget_low_s16(b1));
+        sum1 = vmlal_s16(sum1, vget_high_s16(w1), vget_high_s16(b1));
+        sum1 = vmlal_s16(sum1, vget_low_s16(w2), vget_low_s16(b2));
+        sum1 = vmlal_s16(sum1, vget_high_s16(w2), vget_high_s16(b2));
+        res = vpadd_s32(vpadd_s32(vget_low_s32(sum0), vget_high_s32(sum0)),
+                        vpadd_s32(vget_low_s32(sum1), vget_high_s32(sum1)));
+        /* An arithmetic right shift, then saturation to 16 bits */
+        res = vshl_s32(res, sh);
+        res16 = vqmovn_s32(vcombine_s32(res, res));
+        G722_STATS(g722_tally.saturations += (vget_lane_s32(res, 0) != vget_lane_s16(res16, 0))
+                                           + (vget_lane_s32(res, 1) != vget_lane_s16(res16, 1)));
+        out[2*k] = vget_lane_s16(res16, 0);
+        out[2*k + 1] = vget_lane_s16(res16, 1);
+    }
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+g722_qmf_fn g722_qmf_select(void)
+{
+#if defined(G722_CPU_X86)
+#if defined(G722_CPU_AVX)
+    if (g722_cpu_has_avx2())
+        return qmf_avx2;
+#endif
+    if (g722_cpu_has_sse2())
+        return qmf_sse2;
+#elif defined(G722_CPU_NEON)
+    return qmf_neon;
+#endif
+    return qmf_scalar;
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
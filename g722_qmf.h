@@ -0,0 +1,43 @@
+/*
+ * g722_qmf.h - The ITU G.722 codec, block QMF kernels.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  The transmit and receive QMFs do not feed back into the ADPCM state, so
+ *  they are evaluated over whole blocks of sample pairs, separately from
+ *  the serial ADPCM pass.
+ */
+
+/*! \file */
+
+#pragma once
+
+#include <stdint.h>
+
+/*! Number of history samples a QMF window reaches back beyond the current pair. */
+#define G722_QMF_HIST 22
+/*! Number of sample pairs processed per QMF pass. */
+#define G722_QMF_BLOCK 128
+
+/*! A pair of 24-tap dot products, one per output of a sample pair. */
+struct g722_qmf_taps
+{
+    int16_t c[2][24];
+};
+
+/*! Evaluate the QMF over a block of sample pairs.
+    \param x The signal, G722_QMF_HIST history samples followed by 2*pairs new ones.
+    \param pairs The number of sample pairs to produce.
+    \param shift The right shift applied to each dot product before saturation.
+    \param taps The two sets of taps.
+    \param out The output, 2*pairs saturated samples, interleaved as per taps. */
+typedef void (*g722_qmf_fn)(const int16_t x[], int pairs, int shift,
+  const struct g722_qmf_taps *taps, int16_t out[]);
+
+/*! Taps producing xlow, xhigh from the transmit QMF history. */
+extern const struct g722_qmf_taps g722_qmf_tx_taps;
+/*! Taps producing the two output samples from the receive QMF history. */
+extern const struct g722_qmf_taps g722_qmf_rx_taps;
+
+/*! Pick the fastest QMF kernel supported by the CPU we are running on. */
+g722_qmf_fn g722_qmf_select(void);
@@ -0,0 +1,80 @@
+/*
+ * g722_quantl.h - The ITU G.722 codec, low band quantiser search.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  Block 1L QUANTL looks for the first of the det scaled q6[1..29]
+ *  thresholds above the magnitude of the difference signal. The thresholds
+ *  grow with the index, so that index is one plus the number of thresholds
+ *  at or below the magnitude, which is found here without data dependent
+ *  branches: a compare and count against all the thresholds at once with
+ *  SSE2, or a branch free binary search elsewhere.
+ */
+
+/*! \file */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "g722_cpu.h"
+#include "g722_tables.h"
+
+#if defined(G722_CPU_SSE2_BASELINE)
+static inline int g722_ctz(unsigned int x)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+
+    _BitScanForward(&i, x);
+    return (int) i;
+#else
+    return __builtin_ctz(x);
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+/*! Find the QUANTL index for a difference signal magnitude.
+    \param wd The magnitude, as 0 to 32767.
+    \param det The low band scale factor, as 32 to 32064.
+    \return The index, as 1 to 30, of the first threshold above wd. */
+static inline int g722_quantl_index(int wd, int det)
+{
+#if defined(G722_CPU_SSE2_BASELINE)
+    const __m128i *q = (const __m128i *) g722_tables.q6x16;
+    __m128i vdet;
+    __m128i vwd;
+    __m128i gt0;
+    __m128i gt1;
+    __m128i gt2;
+    __m128i gt3;
+    unsigned int gt;
+
+    /* The unsigned high half of (q6[i] << 4)*det is (q6[i]*det) >> 12. The
+       thresholds fit in 15 bits, so signed compares are fine. */
+    vdet = _mm_set1_epi16((short) det);
+    vwd = _mm_set1_epi16((short) wd);
+    gt0 = _mm_cmpgt_epi16(_mm_mulhi_epu16(_mm_load_si128(q), vdet), vwd);
+    gt1 = _mm_cmpgt_epi16(_mm_mulhi_epu16(_mm_load_si128(q + 1), vdet), vwd);
+    gt2 = _mm_cmpgt_epi16(_mm_mulhi_epu16(_mm_load_si128(q + 2), vdet), vwd);
+    gt3 = _mm_cmpgt_epi16(_mm_mulhi_epu16(_mm_load_si128(q + 3), vdet), vwd);
+    gt = (unsigned int) _mm_movemask_epi8(_mm_packs_epi16(gt0, gt1))
+       | ((unsigned int) _mm_movemask_epi8(_mm_packs_epi16(gt2, gt3)) << 16);
+    /* The thresholds above wd are a run at the top of the 29 */
+    return 1 + g722_ctz(gt | (1U << 29));
+#else
+    int i;
+
+    /* The largest i with threshold i at or below wd, q6[0] being 0 */
+    i = 0;
+    i += (((g722_tables.q6[i + 16]*det) >> 12) <= wd) << 4;
+    i += (((g722_tables.q6[i + 8]*det) >> 12) <= wd) << 3;
+    i += (((g722_tables.q6[i + 4]*det) >> 12) <= wd) << 2;
+    i += ((((g722_tables.q6[i + 2]*det) >> 12) <= wd) & (i < 28)) << 1;
+    i += (((g722_tables.q6[i + 1]*det) >> 12) <= wd);
+    return i + 1;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
@@ -0,0 +1,119 @@
+/*
+ * g722_resample.c - The ITU G.722 codec, 48k samples/second rate conversion.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  Kaiser windowed sinc low pass filters (beta 5.65), with their DC gain
+ *  exactly 1 in Q14. The absolute sum of the taps is under 2.1 in Q14, so
+ *  no dot product with 16 bit samples can overflow 32 bits, even after the
+ *  interpolator's gain of ratio is applied to a single phase.
+ */
+
+/*! \file */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "g722_private.h"
+#include "g722_common.h"
+#include "g722_resample.h"
+
+/* 96 taps, -6dB at 8kHz, better than -59dB from 9kHz */
+static const int16_t rs_16k_taps[96] =
+{
+           -1,    -3,    -2,     3,     7,     4,    -5,   -12,    -7,     9,    20,    12,
+          -14,   -32,   -18,    21,    47,    26,   -30,   -67,   -37,    42,    93,    51,
+          -57,  -126,   -70,    77,   171,    94,  -104,  -230,  -127,   141,   313,   174,
+         -195,  -438,  -248,   283,   652,   382,  -458, -1133,  -735,  1036,  3469,  5214,
+         5214,  3469,  1036,  -735, -1133,  -458,   382,   652,   283,  -248,  -438,  -195,
+          174,   313,   141,  -127,  -230,  -104,    94,   171,    77,   -70,  -126,   -57,
+           51,    93,    42,   -37,   -67,   -30,    26,    47,    21,   -18,   -32,   -14,
+           12,    20,     9,    -7,   -12,    -5,     4,     7,     3,    -2,    -3,    -1
+};
+
+/* 144 taps, -6dB at 4kHz, better than -55dB from 4.6kHz */
+static const int16_t rs_8k_taps[144] =
+{
+            0,    -1,    -2,    -3,    -2,    -1,     1,     4,     6,     7,     5,     2,
+           -3,    -8,   -12,   -13,   -11,    -4,     5,    14,    21,    23,    18,     7,
+           -8,   -24,   -35,   -38,   -30,   -12,    13,    37,    55,    59,    46,    18,
+          -19,   -57,   -83,   -89,   -70,   -27,    29,    85,   124,   132,   103,    40,
+          -43,  -126,  -185,  -198,  -156,   -61,    66,   195,   288,   312,   249,   100,
+         -110,  -332,  -507,  -572,  -478,  -203,   242,   811,  1431,  2009,  2456,  2702,
+         2702,  2456,  2009,  1431,   811,   242,  -203,  -478,  -572,  -507,  -332,  -110,
+          100,   249,   312,   288,   195,    66,   -61,  -156,  -198,  -185,  -126,   -43,
+           40,   103,   132,   124,    85,    29,   -27,   -70,   -89,   -83,   -57,   -19,
+           18,    46,    59,    55,    37,    13,   -12,   -30,   -38,   -35,   -24,    -8,
+            7,    18,    23,    21,    14,     5,    -4,   -11,   -13,   -12,    -8,    -3,
+            2,     5,     7,     6,     4,     1,    -1,    -2,    -3,    -2,    -1,     0
+};
+
+const struct g722_rs_filter g722_rs_16k =
+{
+    3, 96, rs_16k_taps
+};
+
+const struct g722_rs_filter g722_rs_8k =
+{
+    6, 144, rs_8k_taps
+};
+
+int g722_rs_decimate(const struct g722_rs_filter *f, int16_t hist[], uint8_t *phase,
+  const int16_t in[], int len, int16_t out[])
+{
+    int16_t xbuf[G722_RS_HIST + G722_RS_BLOCK];
+    const int16_t *x;
+    int32_t sum;
+    int outlen;
+    int i;
+    int k;
+
+    memcpy(xbuf, hist, G722_RS_HIST*sizeof(xbuf[0]));
+    memcpy(xbuf + G722_RS_HIST, in, len*sizeof(xbuf[0]));
+    outlen = 0;
+    /* The taps are symmetric, so the dot product needs no reversal */
+    for (i = f->ratio - 1 - *phase;  i < len;  i += f->ratio)
+    {
+        x = xbuf + G722_RS_HIST + i + 1 - f->taps;
+        sum = 0;
+        for (k = 0;  k < f->taps;  k++)
+            sum += (int32_t) f->h[k]*x[k];
+        out[outlen++] = saturate((sum + 8192) >> 14);
+    }
+    *phase = (uint8_t) ((*phase + len) % f->ratio);
+    memcpy(hist, xbuf + len, G722_RS_HIST*sizeof(xbuf[0]));
+    return outlen;
+}
+/*- End of function --------------------------------------------------------*/
+
+void g722_rs_interpolate(const struct g722_rs_filter *f, int16_t hist[],
+  const int16_t in[], int len, int16_t out[])
+{
+    int16_t xbuf[G722_RS_UP_HIST + 2*G722_QMF_BLOCK];
+    const int16_t *x;
+    int32_t sum;
+    int n;
+    int i;
+    int k;
+    int p;
+
+    memcpy(xbuf, hist, G722_RS_UP_HIST*sizeof(xbuf[0]));
+    memcpy(xbuf + G722_RS_UP_HIST, in, len*sizeof(xbuf[0]));
+    n = f->taps/f->ratio;
+    for (i = 0;  i < len;  i++)
+    {
+        x = xbuf + G722_RS_UP_HIST + i;
+        /* Phase p of output i takes taps p, p + ratio, ... against the
+           newest input backwards */
+        for (p = 0;  p < f->ratio;  p++)
+        {
+            sum = 0;
+            for (k = 0;  k < n;  k++)
+                sum += (int32_t) f->h[p + k*f->ratio]*x[-k];
+            out[f->ratio*i + p] = saturate((sum*f->ratio + 8192) >> 14);
+        }
+    }
+    memcpy(hist, xbuf + len, G722_RS_UP_HIST*sizeof(xbuf[0]));
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
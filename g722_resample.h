@@ -0,0 +1,56 @@
+/*
+ * g722_resample.h - The ITU G.722 codec, 48k samples/second rate conversion.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  Polyphase FIR decimators and interpolators between 48k samples/second
+ *  linear audio and the 16k (or 8k) samples/second the codec works at. Only
+ *  the outputs that are kept are ever computed, and the arithmetic is plain
+ *  integer, so the results are the same on every CPU.
+ */
+
+/*! \file */
+
+#pragma once
+
+#include <stdint.h>
+
+/*! Number of 48k history samples the longest decimator reaches back. */
+#define G722_RS_HIST 143
+/*! Number of low rate history samples the longest interpolator phase reaches back. */
+#define G722_RS_UP_HIST 31
+/*! Number of 48k samples decimated per pass. */
+#define G722_RS_BLOCK 768
+
+/*! A symmetric low pass prototype, in Q14, for one rate ratio. */
+struct g722_rs_filter
+{
+    int ratio;
+    int taps;
+    const int16_t *h;
+};
+
+/*! 48k to or from 16k, passing 0-7kHz. */
+extern const struct g722_rs_filter g722_rs_16k;
+/*! 48k to or from 8k, passing 0-3.4kHz. */
+extern const struct g722_rs_filter g722_rs_8k;
+
+/*! Decimate a block of 48k samples.
+    \param f The filter.
+    \param hist The last G722_RS_HIST input samples, updated.
+    \param phase The number of input samples since the last output, updated.
+    \param in The input.
+    \param len The number of input samples, at most G722_RS_BLOCK.
+    \param out The output, up to len/ratio + 1 samples.
+    \return The number of output samples. */
+int g722_rs_decimate(const struct g722_rs_filter *f, int16_t hist[], uint8_t *phase,
+  const int16_t in[], int len, int16_t out[]);
+
+/*! Interpolate a block of low rate samples up to 48k.
+    \param f The filter.
+    \param hist The last G722_RS_UP_HIST input samples, updated.
+    \param in The input.
+    \param len The number of input samples, at most 2*G722_QMF_BLOCK.
+    \param out The output, ratio*len samples. */
+void g722_rs_interpolate(const struct g722_rs_filter *f, int16_t hist[],
+  const int16_t in[], int len, int16_t out[]);
@@ -0,0 +1,192 @@
+/*
+ * g722_rtp.c - The ITU G.722 codec, RTP payload packing and unpacking.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  The packed encoder keeps the bits of a part filled byte in its state,
+ *  so any number of codes makes a whole number of bytes. That lets a list
+ *  of buffers be filled exactly, each with as many codes as it can take,
+ *  straight from the encoder.
+ */
+
+/*! \file */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "g722_private.h"
+#include "g722_common.h"
+#include "g722_rtp.h"
+
+/* Fixed part of the RTP header, RFC 3550 */
+#define RTP_HDR_LEN 12
+#define RTP_VERSION 2
+
+/* The number of codes len samples make */
+static int encoder_codes(const G722_ENC_CTX *s, int len)
+{
+    return (s->eight_k)  ?  len  :  len/2;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* The number of bytes ncodes codes fill, after any bits left over */
+static int64_t encoder_bytes(const G722_ENC_CTX *s, int64_t ncodes)
+{
+    if (!s->packed)
+        return ncodes;
+    return (ncodes*s->bits_per_sample + s->out_bits) >> 3;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_payload_size(const G722_ENC_CTX *s, int len)
+{
+    if (len <= 0)
+        return 0;
+    return (int) encoder_bytes(s, encoder_codes(s, len));
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_encode(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t pkt[], int pkt_size, int offset)
+{
+    if (offset < 0  ||  offset > pkt_size  ||  g722_rtp_payload_size(s, len) > pkt_size - offset)
+        return -1;
+    if (len <= 0)
+        return offset;
+    return offset + g722_encode(s, amp, len, pkt + offset);
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_encodev(G722_ENC_CTX *s, const int16_t amp[], int len, const struct g722_iov iov[], int iovcnt)
+{
+    int64_t room;
+    int64_t codes;
+    uint8_t *dst;
+    size_t space;
+    int bytes;
+    int total;
+    int n;
+    int i;
+    int j;
+
+    if (len <= 0)
+        return 0;
+    room = 0;
+    for (i = 0;  i < iovcnt;  i++)
+        room += iov[i].iov_len;
+    if (g722_rtp_payload_size(s, len) > room)
+        return -1;
+
+    total = 0;
+    j = 0;
+    for (i = 0;  i < iovcnt  &&  j < len;  i++)
+    {
+        dst = (uint8_t *) iov[i].iov_base;
+        space = iov[i].iov_len;
+        while (space > 0  &&  j < len)
+        {
+            /* The most codes that fill no more than the space left, which
+               packed to 6 or 7 bits leaves the space exactly filled */
+            if (s->packed)
+                codes = ((int64_t) space*8 + 7 - s->out_bits)/s->bits_per_sample;
+            else
+                codes = space;
+            if (codes > encoder_codes(s, len - j))
+                codes = encoder_codes(s, len - j);
+            if (codes == 0)
+                break;
+            n = (s->eight_k)  ?  (int) codes  :  2*(int) codes;
+            bytes = g722_encode(s, amp + j, n, dst);
+            dst += bytes;
+            space -= bytes;
+            total += bytes;
+            j += n;
+        }
+    }
+    return total;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_payload(const uint8_t pkt[], int len, const uint8_t **payload)
+{
+    int offset;
+    int pad;
+
+    if (len < RTP_HDR_LEN  ||  (pkt[0] >> 6) != RTP_VERSION)
+        return -1;
+    /* The CSRCs */
+    offset = RTP_HDR_LEN + 4*(pkt[0] & 0x0F);
+    /* The header extension, a word of profile and length, then length words */
+    if ((pkt[0] & 0x10))
+    {
+        if (offset + 4 > len)
+            return -1;
+        offset += 4 + 4*((pkt[offset + 2] << 8) | pkt[offset + 3]);
+    }
+    if (offset > len)
+        return -1;
+    /* The padding, whose last byte is its length */
+    if ((pkt[0] & 0x20))
+    {
+        if (len == offset)
+            return -1;
+        pad = pkt[len - 1];
+        if (pad == 0  ||  pad > len - offset)
+            return -1;
+        len -= pad;
+    }
+    *payload = pkt + offset;
+    return len - offset;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_decode(G722_DEC_CTX *s, const uint8_t pkt[], int len, int16_t amp[])
+{
+    const uint8_t *payload;
+
+    if ((len = g722_rtp_payload(pkt, len, &payload)) < 0)
+        return -1;
+    return g722_decode(s, payload, len, amp);
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_decodev(G722_DEC_CTX *s, const struct g722_iov payloads[], int n, int16_t amp[])
+{
+    int total;
+    int i;
+
+    total = 0;
+    for (i = 0;  i < n;  i++)
+        total += g722_decode(s, (const uint8_t *) payloads[i].iov_base, (int) payloads[i].iov_len, amp + total);
+    return total;
+}
+/*- End of function --------------------------------------------------------*/
+
+uint32_t g722_rtp_encoder_ticks(const G722_ENC_CTX *s, int len)
+{
+    /* One tick per code */
+    return (len > 0)  ?  (uint32_t) encoder_codes(s, len)  :  0;
+}
+/*- End of function --------------------------------------------------------*/
+
+uint32_t g722_rtp_decoder_ticks(const G722_DEC_CTX *s, int len)
+{
+    if (len <= 0)
+        return 0;
+    if (!s->packed)
+        return (uint32_t) len;
+    return (uint32_t) (((int64_t) len*8)/s->bits_per_sample);
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_rtp_decoder_samples(const G722_DEC_CTX *s, uint32_t ticks)
+{
+    int64_t samples;
+
+    /* A wrapped timestamp difference, from a late or reordered packet,
+       looks like a huge gap, and is no count of samples */
+    samples = (s->eight_k)  ?  (int64_t) ticks  :  2*(int64_t) ticks;
+    return (samples <= INT_MAX)  ?  (int) samples  :  -1;
+}
+/*- End of function --------------------------------------------------------*/
+/*- End of file ------------------------------------------------------------*/
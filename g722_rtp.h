@@ -0,0 +1,96 @@
+/*
+ * g722_rtp.h - The ITU G.722 codec, RTP payload packing and unpacking.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ */
+
+
+/*! \file */
+
+#pragma once
+
+#include "g722_encoder.h"
+#include "g722_decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \page g722_rtp_page G.722 over RTP
+\section g722_rtp_page_sec_1 What does it do?
+These calls encode a frame straight into the payload of an outgoing RTP
+packet, or into a list of buffers, and decode straight from the payload
+of a received datagram, so no payload is ever copied on its own.
+
+RFC 3551 gives G.722 an RTP clock of 8000Hz, although it samples at
+16000Hz, so that a timestamp advances by one for each G.722 code. The
+timestamp calls convert between RTP time and samples on that basis, for
+every rate and for 8k samples/second linear audio alike.
+*/
+
+/*! A buffer, laid out as struct iovec is on POSIX systems, so that an
+    array of either may be passed where the other is expected. */
+struct g722_iov
+{
+    void *iov_base;
+    size_t iov_len;
+};
+
+/*! \return The number of payload bytes that encoding len samples gives,
+            from the encoder's current state. */
+int g722_rtp_payload_size(const G722_ENC_CTX *s, int len);
+/*! Encode a frame into an RTP packet, after whatever header the caller
+    has written or will write.
+    \param s The encoder context.
+    \param amp The linear audio.
+    \param len The number of samples.
+    \param pkt The packet buffer.
+    \param pkt_size The size of the packet buffer.
+    \param offset Where the payload starts, after the RTP header.
+    \return The length of the packet, offset plus the payload, or -1 if the
+            payload would not fit, in which case nothing is encoded. */
+int g722_rtp_encode(G722_ENC_CTX *s, const int16_t amp[], int len, uint8_t pkt[], int pkt_size, int offset);
+/*! Encode a frame into a list of buffers, filling each in turn.
+    \param s The encoder context.
+    \param amp The linear audio.
+    \param len The number of samples.
+    \param iov The buffers.
+    \param iovcnt The number of buffers.
+    \return The number of payload bytes, or -1 if they would not fit in
+            the buffers, in which case nothing is encoded. */
+int g722_rtp_encodev(G722_ENC_CTX *s, const int16_t amp[], int len, const struct g722_iov iov[], int iovcnt);
+/*! Find the payload of an RTP packet, past any CSRCs and header extension,
+    and short of any padding.
+    \param pkt The packet.
+    \param len The length of the packet.
+    \param payload Set to the start of the payload.
+    \return The length of the payload, or -1 if the packet is not valid RTP. */
+int g722_rtp_payload(const uint8_t pkt[], int len, const uint8_t **payload);
+/*! Decode the payload of an RTP packet, in place in the packet.
+    \param s The decoder context.
+    \param pkt The packet.
+    \param len The length of the packet.
+    \param amp The linear audio.
+    \return The number of samples, or -1 if the packet is not valid RTP. */
+int g722_rtp_decode(G722_DEC_CTX *s, const uint8_t pkt[], int len, int16_t amp[]);
+/*! Decode a run of payloads, such as a jitter buffer hands out, back to
+    back into one buffer.
+    \param s The decoder context.
+    \param payloads The payloads.
+    \param n The number of payloads.
+    \param amp The linear audio.
+    \return The number of samples. */
+int g722_rtp_decodev(G722_DEC_CTX *s, const struct g722_iov payloads[], int n, int16_t amp[]);
+/*! \return The RTP timestamp increment for encoding len samples. */
+uint32_t g722_rtp_encoder_ticks(const G722_ENC_CTX *s, int len);
+/*! \return The RTP timestamp increment for a payload of len bytes. */
+uint32_t g722_rtp_decoder_ticks(const G722_DEC_CTX *s, int len);
+/*! \return The number of samples the decoder gives over an RTP timestamp
+            increment, such as the gap a lost packet leaves, or -1 if that
+            is more than an int holds. The increment of a late or
+            reordered packet wraps round to a huge one, and gives -1. */
+int g722_rtp_decoder_samples(const G722_DEC_CTX *s, uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,224 @@
+/*
+ * g722_tables.c - The ITU G.722 codec, shared read only tables.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ *
+ *  The values are those of the tables the encoder and the decoder used to
+ *  keep their own copies of, all of which fit in 16 bits, and some products
+ *  of them that take the place of the per sample sums.
+ */
+
+/*! \file */
+
+#include <stdint.h>
+
+#include "g722_tables.h"
+
+G722_ALIGN64 const struct g722_tables g722_tables =
+{
+    /* q6x16, q6[1..29] << 4, and three zero thresholds that every magnitude passes */
+    {
+          560,  1152,  1760,  2400,  3040,  3728,  4416,  5168,
+         5920,  6752,  7568,  8480,  9392, 10400, 11424, 12576,
+        13728, 15040, 16368, 17936, 19504, 21424, 23328, 25792,
+        28240, 31680, 35120, 40912, 46704,     0,     0,     0
+    },
+    /* q6 */
+    {
+           0,   35,   72,  110,  150,  190,  233,  276,
+         323,  370,  422,  473,  530,  587,  650,  714,
+         786,  858,  940, 1023, 1121, 1219, 1339, 1458,
+        1612, 1765, 1980, 2195, 2557, 2919,    0,    0
+    },
+    /* iln */
+    {
+         0, 63, 62, 31, 30, 29, 28, 27,
+        26, 25, 24, 23, 22, 21, 20, 19,
+        18, 17, 16, 15, 14, 13, 12, 11,
+        10,  9,  8,  7,  6,  5,  4,  0
+    },
+    /* ilp */
+    {
+         0, 61, 60, 59, 58, 57, 56, 55,
+        54, 53, 52, 51, 50, 49, 48, 47,
+        46, 45, 44, 43, 42, 41, 40, 39,
+        38, 37, 36, 35, 34, 33, 32,  0
+    },
+    /* qm4 */
+    {
+             0, -20456, -12896, -8968,
+         -6288,  -4240,  -2584, -1200,
+         20456,  12896,   8968,  6288,
+          4240,   2584,   1200,     0
+    },
+    /* wl_ril, wl[rl42[i]] */
+    {
+         -60, 3042, 1198,  538,  334,  172,   58,  -30,
+        3042, 1198,  538,  334,  172,   58,  -30,  -60
+    },
+    /* qm2 */
+    {
+        -7408,  -1616,   7408,   1616
+    },
+    /* wh_ih, wh[rh2[i]] */
+    {
+        798, -214, 798, -214
+    },
+    /* ihn */
+    {
+        0, 1, 0
+    },
+    /* ihp */
+    {
+        0, 3, 2
+    },
+    /* det, ilb[i & 31] shifted by 10 - (i >> 5), times 4 */
+    {
+            8,     8,     8,     8,     8,     8,     8,     8,
+            8,     8,     8,     8,     8,     8,     8,     8,
+            8,     8,     8,    12,    12,    12,    12,    12,
+           12,    12,    12,    12,    12,    12,    12,    12,
+           16,    16,    16,    16,    16,    16,    16,    16,
+           16,    16,    16,    20,    20,    20,    20,    20,
+           20,    20,    20,    24,    24,    24,    24,    24,
+           24,    24,    28,    28,    28,    28,    28,    28,
+           32,    32,    32,    32,    32,    32,    36,    36,
+           36,    36,    36,    40,    40,    40,    40,    44,
+           44,    44,    44,    48,    48,    48,    48,    52,
+           52,    52,    56,    56,    56,    56,    60,    60,
+           64,    64,    64,    68,    68,    68,    72,    72,
+           76,    76,    76,    80,    80,    84,    84,    88,
+           88,    92,    92,    96,    96,   100,   100,   104,
+          104,   108,   112,   112,   116,   116,   120,   124,
+          128,   128,   132,   136,   136,   140,   144,   148,
+          152,   152,   156,   160,   164,   168,   172,   176,
+          180,   184,   188,   192,   196,   200,   204,   208,
+          212,   220,   224,   228,   232,   236,   244,   248,
+          256,   260,   264,   272,   276,   284,   288,   296,
+          304,   308,   316,   324,   332,   336,   344,   352,
+          360,   368,   376,   384,   392,   400,   412,   420,
+          428,   440,   448,   456,   468,   476,   488,   500,
+          512,   520,   532,   544,   556,   568,   580,   592,
+          608,   620,   632,   648,   664,   676,   692,   708,
+          724,   740,   756,   772,   788,   804,   824,   840,
+          860,   880,   896,   916,   936,   956,   980,  1000,
+         1024,  1044,  1068,  1092,  1116,  1140,  1164,  1188,
+         1216,  1244,  1268,  1296,  1328,  1356,  1384,  1416,
+         1448,  1480,  1512,  1544,  1576,  1612,  1648,  1684,
+         1720,  1760,  1796,  1836,  1876,  1916,  1960,  2004,
+         2048,  2092,  2136,  2184,  2232,  2280,  2332,  2380,
+         2432,  2488,  2540,  2596,  2656,  2712,  2772,  2832,
+         2896,  2960,  3024,  3088,  3156,  3228,  3296,  3368,
+         3444,  3520,  3596,  3676,  3756,  3836,  3920,  4008,
+         4096,  4184,  4276,  4372,  4464,  4564,  4664,  4764,
+         4868,  4976,  5084,  5196,  5312,  5428,  5548,  5668,
+         5792,  5920,  6048,  6180,  6316,  6456,  6596,  6740,
+         6888,  7040,  7192,  7352,  7512,  7676,  7844,  8016,
+         8192,  8372,  8556,  8744,  8932,  9128,  9328,  9532,
+         9740,  9956, 10172, 10396, 10624, 10856, 11096, 11336,
+        11584, 11840, 12100, 12364, 12632, 12912, 13192, 13484,
+        13776, 14080, 14388, 14704, 15024, 15352, 15688, 16032,
+        16384
+    },
+    /* qm5 */
+    {
+           -280,   -280, -23352, -17560,
+         -14120, -11664,  -9752,  -8184,
+          -6864,  -5712,  -4696,  -3784,
+          -2960,  -2208,  -1520,   -880,
+          23352,  17560,  14120,  11664,
+           9752,   8184,   6864,   5712,
+           4696,   3784,   2960,   2208,
+           1520,    880,    280,   -280
+    },
+    /* qm6 */
+    {
+           -136,   -136,   -136,   -136,
+         -24808, -21904, -19008, -16704,
+         -14984, -13512, -12280, -11192,
+         -10232,  -9360,  -8576,  -7856,
+          -7192,  -6576,  -6000,  -5456,
+          -4944,  -4464,  -4008,  -3576,
+          -3168,  -2776,  -2400,  -2032,
+          -1688,  -1360,  -1040,   -728,
+          24808,  21904,  19008,  16704,
+          14984,  13512,  12280,  11192,
+          10232,   9360,   8576,   7856,
+           7192,   6576,   6000,   5456,
+           4944,   4464,   4008,   3576,
+           3168,   2776,   2400,   2032,
+           1688,   1360,   1040,    728,
+            432,    136,   -432,   -136
+    },
+    /* ulaw, G.711 mu-law expanded to 16 bits */
+    {
+        -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956,
+        -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764,
+        -15996, -15484, -14972, -14460, -13948, -13436, -12924, -12412,
+        -11900, -11388, -10876, -10364,  -9852,  -9340,  -8828,  -8316,
+         -7932,  -7676,  -7420,  -7164,  -6908,  -6652,  -6396,  -6140,
+         -5884,  -5628,  -5372,  -5116,  -4860,  -4604,  -4348,  -4092,
+         -3900,  -3772,  -3644,  -3516,  -3388,  -3260,  -3132,  -3004,
+         -2876,  -2748,  -2620,  -2492,  -2364,  -2236,  -2108,  -1980,
+         -1884,  -1820,  -1756,  -1692,  -1628,  -1564,  -1500,  -1436,
+         -1372,  -1308,  -1244,  -1180,  -1116,  -1052,   -988,   -924,
+          -876,   -844,   -812,   -780,   -748,   -716,   -684,   -652,
+          -620,   -588,   -556,   -524,   -492,   -460,   -428,   -396,
+          -372,   -356,   -340,   -324,   -308,   -292,   -276,   -260,
+          -244,   -228,   -212,   -196,   -180,   -164,   -148,   -132,
+          -120,   -112,   -104,    -96,    -88,    -80,    -72,    -64,
+           -56,    -48,    -40,    -32,    -24,    -16,     -8,      0,
+         32124,  31100,  30076,  29052,  28028,  27004,  25980,  24956,
+         23932,  22908,  21884,  20860,  19836,  18812,  17788,  16764,
+         15996,  15484,  14972,  14460,  13948,  13436,  12924,  12412,
+         11900,  11388,  10876,  10364,   9852,   9340,   8828,   8316,
+          7932,   7676,   7420,   7164,   6908,   6652,   6396,   6140,
+          5884,   5628,   5372,   5116,   4860,   4604,   4348,   4092,
+          3900,   3772,   3644,   3516,   3388,   3260,   3132,   3004,
+          2876,   2748,   2620,   2492,   2364,   2236,   2108,   1980,
+          1884,   1820,   1756,   1692,   1628,   1564,   1500,   1436,
+          1372,   1308,   1244,   1180,   1116,   1052,    988,    924,
+           876,    844,    812,    780,    748,    716,    684,    652,
+           620,    588,    556,    524,    492,    460,    428,    396,
+           372,    356,    340,    324,    308,    292,    276,    260,
+           244,    228,    212,    196,    180,    164,    148,    132,
+           120,    112,    104,     96,     88,     80,     72,     64,
+            56,     48,     40,     32,     24,     16,      8,      0
+    },
+    /* alaw, G.711 A-law expanded to 16 bits */
+    {
+         -5504,  -5248,  -6016,  -5760,  -4480,  -4224,  -4992,  -4736,
+         -7552,  -7296,  -8064,  -7808,  -6528,  -6272,  -7040,  -6784,
+         -2752,  -2624,  -3008,  -2880,  -2240,  -2112,  -2496,  -2368,
+         -3776,  -3648,  -4032,  -3904,  -3264,  -3136,  -3520,  -3392,
+        -22016, -20992, -24064, -23040, -17920, -16896, -19968, -18944,
+        -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136,
+        -11008, -10496, -12032, -11520,  -8960,  -8448,  -9984,  -9472,
+        -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568,
+          -344,   -328,   -376,   -360,   -280,   -264,   -312,   -296,
+          -472,   -456,   -504,   -488,   -408,   -392,   -440,   -424,
+           -88,    -72,   -120,   -104,    -24,     -8,    -56,    -40,
+          -216,   -200,   -248,   -232,   -152,   -136,   -184,   -168,
+         -1376,  -1312,  -1504,  -1440,  -1120,  -1056,  -1248,  -1184,
+         -1888,  -1824,  -2016,  -1952,  -1632,  -1568,  -1760,  -1696,
+          -688,   -656,   -752,   -720,   -560,   -528,   -624,   -592,
+          -944,   -912,  -1008,   -976,   -816,   -784,   -880,   -848,
+          5504,   5248,   6016,   5760,   4480,   4224,   4992,   4736,
+          7552,   7296,   8064,   7808,   6528,   6272,   7040,   6784,
+          2752,   2624,   3008,   2880,   2240,   2112,   2496,   2368,
+          3776,   3648,   4032,   3904,   3264,   3136,   3520,   3392,
+         22016,  20992,  24064,  23040,  17920,  16896,  19968,  18944,
+         30208,  29184,  32256,  31232,  26112,  25088,  28160,  27136,
+         11008,  10496,  12032,  11520,   8960,   8448,   9984,   9472,
+         15104,  14592,  16128,  15616,  13056,  12544,  14080,  13568,
+           344,    328,    376,    360,    280,    264,    312,    296,
+           472,    456,    504,    488,    408,    392,    440,    424,
+            88,     72,    120,    104,     24,      8,     56,     40,
+           216,    200,    248,    232,    152,    136,    184,    168,
+          1376,   1312,   1504,   1440,   1120,   1056,   1248,   1184,
+          1888,   1824,   2016,   1952,   1632,   1568,   1760,   1696,
+           688,    656,    752,    720,    560,    528,    624,    592,
+           944,    912,   1008,    976,    816,    784,    880,    848
+    }
+};
+/*- End of file ------------------------------------------------------------*/
@@ -0,0 +1,50 @@
+/*
+ * g722_tables.h - The ITU G.722 codec, shared read only tables.
+ *
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ */
+
+/*! \file */
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#define G722_ALIGN64 __declspec(align(64))
+#else
+#define G722_ALIGN64 __attribute__((aligned(64)))
+#endif
+
+/*! Entries of the scale factor table, one per 64 steps of nb up to 22528. */
+#define G722_DET_TABLE_LEN (22528/64 + 1)
+
+/*! The tables of both the encoder and the decoder, as one cache line aligned
+    block, with the most used ones first. */
+struct g722_tables
+{
+    /*! The QUANTL thresholds, q6[i] << 4, for the SSE2 search. See g722_quantl.h. */
+    uint16_t q6x16[32];
+    int16_t q6[32];
+    int16_t iln[32];
+    int16_t ilp[32];
+    int16_t qm4[16];
+    /*! The low band log scale factor step, wl[rl42[ril]], by 4 bit code. */
+    int16_t wl_ril[16];
+    int16_t qm2[4];
+    /*! The high band log scale factor step, wh[rh2[ihigh]], by 2 bit code. */
+    int16_t wh_ih[4];
+    int16_t ihn[3];
+    int16_t ihp[3];
+    /*! The scale factor for a log scale factor, by nb >> 6. The low band's
+        scale is two octaves under the high band's, so it takes entries 64
+        on. */
+    int16_t det[G722_DET_TABLE_LEN];
+    int16_t qm5[32];
+    int16_t qm6[64];
+    /*! G.711 codes expanded to linear, for the transcoding entry points. See g722_g711.h. */
+    int16_t ulaw[256];
+    int16_t alaw[256];
+};
+
+extern G722_ALIGN64 const struct g722_tables g722_tables;
@@ -25,14 +25,17 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <string.h>
 
 #include <Python.h>
+#include <pythread.h>
 
 #include "G722_numpy_api.h"
 #include "g722_encoder.h"
 #include "g722_decoder.h"
+#include "g722_engine.h"
 
 #define MODULE_BASENAME G722
 
@@ -117,6 +120,9 @@ typedef struct {
     PyObject_HEAD
     G722_DEC_CTX *g722_dctx;
     G722_ENC_CTX *g722_ectx;
+    // The codec runs with the GIL released, these keep each state to one thread
+    PyThread_type_lock dec_lock;
+    PyThread_type_lock enc_lock;
     int sample_rate;
     int bit_rate;
     bool use_numpy;
@@ -124,27 +130,24 @@ typedef struct {
     PyObject *numpy_module;
 } PyG722;
 
+// An array.array of the given type code, holding a copy of nbytes of data
 static PyObject *
-build_pcm16_array(int16_t *array, Py_ssize_t olength) {
+build_typed_array(const char *typecode, const void *data, Py_ssize_t nbytes) {
     PyObject* array_mod = PyImport_ImportModule("array");
     if (!array_mod) {
-        free(array);
         return NULL;
     }
     PyObject* array_ctor = PyObject_GetAttrString(array_mod, "array");
     Py_DECREF(array_mod);
     if (!array_ctor) {
-        free(array);
         return NULL;
     }
-    PyObject* result = PyObject_CallFunction(array_ctor, "s", "h");
+    PyObject* result = PyObject_CallFunction(array_ctor, "s", typecode);
     Py_DECREF(array_ctor);
     if (!result) {
-        free(array);
         return NULL;
     }
-    PyObject* pcm_bytes = PyBytes_FromStringAndSize((const char *)array, olength * sizeof(array[0]));
-    free(array);
+    PyObject* pcm_bytes = PyBytes_FromStringAndSize((const char *)data, nbytes);
     if (!pcm_bytes) {
         Py_DECREF(result);
         return NULL;
@@ -159,8 +162,30 @@ build_pcm16_array(int16_t *array, Py_ssize_t olength) {
     return result;
 }
 
+static PyObject *
+build_pcm16_array(int16_t *array, Py_ssize_t olength) {
+    PyObject *result = build_typed_array("h", array, olength * sizeof(array[0]));
+
+    free(array);
+    return result;
+}
+
+// Decoded samples as decode() returns them, taking ownership of the array
+static PyObject *
+build_pcm16_result(PyG722 *self, int16_t *array, Py_ssize_t olength) {
+    if (self->use_numpy) {
+        if (self->numpy_api == NULL) {
+            free(array);
+            PyErr_SetString(PyExc_RuntimeError, "Internal error: NumPy backend requested but not loaded.");
+            return NULL;
+        }
+        return self->numpy_api->from_pcm16_owned(array, olength);
+    }
+    return build_pcm16_array(array, olength);
+}
+
 static int
-load_numpy_api(PyG722 *self, bool required)
+load_numpy_api(const G722NumpyAPI **api_out, PyObject **module_out, bool required)
 {
     PyObject *numpy_mod = PyImport_ImportModule("G722_numpy");
     PyObject *capsule = NULL;
@@ -193,7 +218,7 @@ load_numpy_api(PyG722 *self, bool required)
 
     api = (const G722NumpyAPI *)PyCapsule_GetPointer(capsule, G722_NUMPY_CAPSULE_NAME);
     Py_DECREF(capsule);
-    if (api == NULL) {
+    if (api == NULL || api->size < sizeof(*api)) {
         Py_DECREF(numpy_mod);
         if (!required) {
             PyErr_Clear();
@@ -205,8 +230,8 @@ load_numpy_api(PyG722 *self, bool required)
         return -1;
     }
 
-    self->numpy_api = api;
-    self->numpy_module = numpy_mod;
+    *api_out = api;
+    *module_out = numpy_mod;
     return 1;
 }
 
@@ -229,6 +254,14 @@ static int PyG722_init(PyG722* self, PyObject* args, PyObject* kwds) {
         PyErr_SetString(PyExc_ValueError, "Bit rate must be 48000, 56000 or 64000");
         return -1;
     }
+    if (self->enc_lock == NULL && (self->enc_lock = PyThread_allocate_lock()) == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (self->dec_lock == NULL && (self->dec_lock = PyThread_allocate_lock()) == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
     options = (sample_rate == 8000) ? G722_SAMPLE_RATE_8000 : G722_DEFAULT;
     self->g722_ectx = g722_encoder_new(bit_rate, options);
     if(self->g722_ectx == NULL) {
@@ -256,7 +289,7 @@ static int PyG722_init(PyG722* self, PyObject* args, PyObject* kwds) {
     }
     if (use_numpy != 0) {
         bool required = (use_numpy > 0);
-        int loaded = load_numpy_api(self, required);
+        int loaded = load_numpy_api(&self->numpy_api, &self->numpy_module, required);
         if (loaded < 0) {
             return -1;
         }
@@ -276,149 +309,232 @@ static int PyG722_init(PyG722* self, PyObject* args, PyObject* kwds) {
 static void PyG722_dealloc(PyG722* self) {
     g722_encoder_destroy(self->g722_ectx);
     g722_decoder_destroy(self->g722_dctx);
+    if (self->enc_lock != NULL)
+        PyThread_free_lock(self->enc_lock);
+    if (self->dec_lock != NULL)
+        PyThread_free_lock(self->dec_lock);
     Py_XDECREF(self->numpy_module);
     Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
-// The encode method for PyG722 objects
-static PyObject *
-PyG722_encode(PyG722* self, PyObject* args) {
-    PyObject* item;
-    PyObject* seq = NULL;
-    int16_t* array;
-    Py_ssize_t length, i, olength;
-    bool from_numpy = false;
-    bool from_buffer = false;
-    bool from_buffer_copy = false;
+// PCM input in any of the forms encode() takes, as native int16 samples
+struct pcm_input {
+    int16_t *array;
+    Py_ssize_t length;
+    PyObject *seq;
     Py_buffer view;
+    bool from_numpy;
+    bool from_buffer;
+    bool from_buffer_copy;
+};
 
-    PyObject *rval = NULL;
-    if (!PyArg_ParseTuple(args, "O", &item)) {
-        PyErr_SetString(PyExc_TypeError, "Takes exactly one argument");
-        goto e0;
+static void
+pcm_input_release(struct pcm_input *in)
+{
+    if (in->from_buffer_copy || (!in->from_numpy && !in->from_buffer)) {
+        free(in->array);
     }
+    Py_XDECREF(in->seq);
+    if (in->from_buffer) {
+        PyBuffer_Release(&in->view);
+    }
+}
+
+static int
+pcm_input_get(const G722NumpyAPI *numpy_api, PyObject* item, struct pcm_input *in)
+{
+    Py_ssize_t i;
 
-    if (self->numpy_api != NULL &&
-        self->numpy_api->check_int16_1d(item, &array, &length)) {
-        from_numpy = true;
-        goto have_input;
+    memset(in, 0, sizeof(*in));
+    if (numpy_api != NULL &&
+        numpy_api->check_int16_1d(item, &in->array, &in->length)) {
+        in->from_numpy = true;
+        return 0;
     }
 
     if (PyObject_CheckBuffer(item) &&
-        PyObject_GetBuffer(item, &view, PyBUF_CONTIG_RO | PyBUF_FORMAT) == 0) {
-        if (view.ndim != 1 || view.itemsize != (Py_ssize_t)sizeof(array[0]) ||
-            !is_i16_buffer_format(view.format)) {
-            PyBuffer_Release(&view);
-        } else if (view.len % sizeof(array[0]) != 0) {
-            PyBuffer_Release(&view);
+        PyObject_GetBuffer(item, &in->view, PyBUF_CONTIG_RO | PyBUF_FORMAT) == 0) {
+        if (in->view.ndim != 1 || in->view.itemsize != (Py_ssize_t)sizeof(in->array[0]) ||
+            !is_i16_buffer_format(in->view.format)) {
+            PyBuffer_Release(&in->view);
+        } else if (in->view.len % sizeof(in->array[0]) != 0) {
+            PyBuffer_Release(&in->view);
             PyErr_SetString(PyExc_TypeError, "Expected buffer with 16-bit samples");
-            goto e0;
+            return -1;
         } else {
-            length = view.len / sizeof(array[0]);
-            if (i16_buffer_format_is_native(view.format)) {
-                array = (int16_t *)view.buf;
-                from_buffer = true;
-                goto have_input;
+            in->length = in->view.len / sizeof(in->array[0]);
+            in->from_buffer = true;
+            if (i16_buffer_format_is_native(in->view.format)) {
+                in->array = (int16_t *)in->view.buf;
+                return 0;
             }
 
-            array = (int16_t *)malloc(length * sizeof(array[0]));
-            if (!array) {
-                PyBuffer_Release(&view);
-                rval = PyErr_NoMemory();
-                goto e0;
+            in->array = (int16_t *)malloc(in->length * sizeof(in->array[0]));
+            if (!in->array) {
+                PyBuffer_Release(&in->view);
+                PyErr_NoMemory();
+                return -1;
             }
-            bool src_is_little = i16_buffer_format_is_little_endian(view.format);
-            for (i = 0; i < length; i++) {
-                const uint8_t *bp = ((const uint8_t *)view.buf) + (i * sizeof(array[0]));
-                array[i] = load_i16(bp, src_is_little);
+            in->from_buffer_copy = true;
+            bool src_is_little = i16_buffer_format_is_little_endian(in->view.format);
+            for (i = 0; i < in->length; i++) {
+                const uint8_t *bp = ((const uint8_t *)in->view.buf) + (i * sizeof(in->array[0]));
+                in->array[i] = load_i16(bp, src_is_little);
             }
-            from_buffer = true;
-            from_buffer_copy = true;
-            goto have_input;
+            return 0;
         }
     } else {
         PyErr_Clear();
     }
 
     // Convert PyObject to a sequence if possible
-    seq = PySequence_Fast(item, "Expected a sequence");
-    if (seq == NULL) {
+    in->seq = PySequence_Fast(item, "Expected a sequence");
+    if (in->seq == NULL) {
         PyErr_SetString(PyExc_TypeError, "Expected a sequence");
-        goto e0;
+        return -1;
     }
 
     // Get the length of the sequence
-    length = PySequence_Size(seq);
-    if (length == -1) {
+    in->length = PySequence_Size(in->seq);
+    if (in->length == -1) {
         PyErr_SetString(PyExc_TypeError, "Error getting sequence length");
-        goto e1;
+        goto e0;
     }
 
     // Allocate memory for the int array
-    array = (int16_t*) malloc(length * sizeof(array[0]));
-    if (!array) {
-        rval = PyErr_NoMemory();
-        goto e1;
+    in->array = (int16_t*) malloc(in->length * sizeof(in->array[0]));
+    if (!in->array) {
+        PyErr_NoMemory();
+        goto e0;
     }
-    for (i = 0; i < length; i++) {
-        PyObject* temp_item = PySequence_Fast_GET_ITEM(seq, i);  // Borrowed reference, no need to Py_DECREF
+    for (i = 0; i < in->length; i++) {
+        PyObject* temp_item = PySequence_Fast_GET_ITEM(in->seq, i);  // Borrowed reference, no need to Py_DECREF
         long tv = PyLong_AsLong(temp_item);
         if (PyErr_Occurred()) {
-            goto e2;
+            goto e0;
         }
         if (tv < -32768 || tv > 32767) {
             PyErr_SetString(PyExc_ValueError, "Value out of range");
-            goto e2;
+            goto e0;
         }
-        array[i] = (int16_t)tv;
+        in->array[i] = (int16_t)tv;
     }
-have_input:
-    olength = self->sample_rate == 8000 ? length : length / 2;
-    PyObject *obuf_obj = PyBytes_FromStringAndSize(NULL, olength);
-    if (obuf_obj == NULL) {
-        rval = PyErr_NoMemory();
-        goto e2;
+    return 0;
+e0:
+    pcm_input_release(in);
+    return -1;
+}
+
+// Positional arguments of a METH_FASTCALL method, which skips building and
+// parsing an argument tuple on every call
+static bool
+check_nargs(const char *name, Py_ssize_t nargs, Py_ssize_t min, Py_ssize_t max)
+{
+    if (nargs >= min && nargs <= max) {
+        return true;
     }
-    uint8_t *buffer = (uint8_t *)PyBytes_AsString(obuf_obj);
-    if (!buffer) {
-        goto e3;
+    if (min == max) {
+        PyErr_Format(PyExc_TypeError, "%s() takes exactly %zd argument%s (%zd given)", name, min,
+          (min == 1) ? "" : "s", nargs);
+    } else {
+        PyErr_Format(PyExc_TypeError, "%s() takes from %zd to %zd arguments (%zd given)", name, min,
+          max, nargs);
     }
-    int obytes = g722_encode(self->g722_ectx, array, length, buffer);
+    return false;
+}
+
+static Py_ssize_t
+encode_locked(PyG722* self, const struct pcm_input *in, uint8_t *buffer)
+{
+    int obytes;
+
+    // The input is a private copy, an immutable or exported buffer, or a
+    // NumPy array we hold a reference to, so it stays put without the GIL
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->enc_lock, WAIT_LOCK);
+    obytes = g722_encode(self->g722_ectx, in->array, in->length, buffer);
+    PyThread_release_lock(self->enc_lock);
+    Py_END_ALLOW_THREADS
+    return obytes;
+}
+
+// The encode method for PyG722 objects
+static PyObject *
+PyG722_encode(PyG722* self, PyObject *const *args, Py_ssize_t nargs) {
+    PyObject* item;
+    PyObject *obuf_obj;
+    struct pcm_input in;
+    Py_ssize_t olength, obytes;
+
+    if (!check_nargs("encode", nargs, 1, 1)) {
+        return NULL;
+    }
+    item = args[0];
+    if (pcm_input_get(self->numpy_api, item, &in) < 0) {
+        return NULL;
+    }
+    olength = self->sample_rate == 8000 ? in.length : in.length / 2;
+    obuf_obj = PyBytes_FromStringAndSize(NULL, olength);
+    if (obuf_obj == NULL) {
+        pcm_input_release(&in);
+        return PyErr_NoMemory();
+    }
+    obytes = encode_locked(self, &in, (uint8_t *)PyBytes_AS_STRING(obuf_obj));
     assert(obytes == olength);
-    rval = obuf_obj;
-    goto e2;
-e3:
-    Py_DECREF(obuf_obj);
-e2:
-    if (from_buffer_copy) {
-        free(array);
-    } else if (!from_numpy && !from_buffer) {
-        free(array);
+    (void)obytes;
+    pcm_input_release(&in);
+    return obuf_obj;
+}
+
+// The encode_into method for PyG722 objects
+static PyObject *
+PyG722_encode_into(PyG722* self, PyObject *const *args, Py_ssize_t nargs) {
+    PyObject *item, *out;
+    struct pcm_input in;
+    Py_buffer oview;
+    Py_ssize_t olength, obytes;
+
+    if (!check_nargs("encode_into", nargs, 2, 2)) {
+        return NULL;
     }
-e1:
-    if (!from_numpy && !from_buffer) {
-        Py_DECREF(seq);
+    item = args[0];
+    out = args[1];
+    if (PyObject_GetBuffer(out, &oview, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) < 0) {
+        return NULL;
     }
-    if (from_buffer) {
-        PyBuffer_Release(&view);
+    if (pcm_input_get(self->numpy_api, item, &in) < 0) {
+        PyBuffer_Release(&oview);
+        return NULL;
     }
-e0:
-    return rval;
+    olength = self->sample_rate == 8000 ? in.length : in.length / 2;
+    if (oview.len < olength) {
+        PyErr_Format(PyExc_ValueError, "Output buffer too small, %zd bytes needed",
+          olength);
+        obytes = -1;
+    } else {
+        obytes = encode_locked(self, &in, (uint8_t *)oview.buf);
+        assert(obytes == olength);
+    }
+    pcm_input_release(&in);
+    PyBuffer_Release(&oview);
+    if (obytes < 0) {
+        return NULL;
+    }
+    return PyLong_FromSsize_t(obytes);
 }
 
 // The get method for PyG722 objects
 static PyObject *
-PyG722_decode(PyG722* self, PyObject* args) {
+PyG722_decode(PyG722* self, PyObject *const *args, Py_ssize_t nargs) {
     PyObject* item;
     uint8_t* buffer;
     int16_t* array;
     Py_ssize_t length, olength;
 
-    // Parse the input tuple to get a bytes object
-    if (!PyArg_ParseTuple(args, "O", &item)) {
-        PyErr_SetString(PyExc_TypeError, "Argument must be a bytes object");
+    if (!check_nargs("decode", nargs, 1, 1)) {
         return NULL;
     }
+    item = args[0];
 
     // Ensure the object is a bytes object
     if (!PyBytes_Check(item)) {
@@ -440,22 +556,610 @@ PyG722_decode(PyG722* self, PyObject* args) {
     if (array == NULL) {
         return PyErr_NoMemory();
     }
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->dec_lock, WAIT_LOCK);
     g722_decode(self->g722_dctx, buffer, length, array);
+    PyThread_release_lock(self->dec_lock);
+    Py_END_ALLOW_THREADS
 
-    if (self->use_numpy) {
-        if (self->numpy_api == NULL) {
-            free(array);
-            PyErr_SetString(PyExc_RuntimeError, "Internal error: NumPy backend requested but not loaded.");
+    return build_pcm16_result(self, array, olength);
+}
+
+// The decode_into method for PyG722 objects
+static PyObject *
+PyG722_decode_into(PyG722* self, PyObject *const *args, Py_ssize_t nargs) {
+    PyObject *item, *out;
+    Py_buffer iview, oview;
+    Py_ssize_t length, olength, i;
+    bool swap;
+    PyObject *rval = NULL;
+
+    if (!check_nargs("decode_into", nargs, 2, 2)) {
+        return NULL;
+    }
+    item = args[0];
+    out = args[1];
+    if (PyObject_GetBuffer(item, &iview, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    if (PyObject_GetBuffer(out, &oview, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+        goto e0;
+    }
+    // Either 16-bit samples in any byte order, or raw bytes taking native ones
+    if (oview.itemsize == (Py_ssize_t)sizeof(int16_t) && is_i16_buffer_format(oview.format)) {
+        swap = !i16_buffer_format_is_native(oview.format);
+    } else if (oview.itemsize == 1 && (oview.format == NULL ||
+      strcmp(oview.format, "B") == 0 || strcmp(oview.format, "b") == 0 ||
+      strcmp(oview.format, "c") == 0)) {
+        swap = false;
+    } else {
+        PyErr_SetString(PyExc_TypeError, "Expected a writable buffer of bytes or 16-bit samples");
+        goto e1;
+    }
+    length = iview.len;
+    olength = self->sample_rate == 8000 ? length : length * 2;
+    if (oview.len / (Py_ssize_t)sizeof(int16_t) < olength) {
+        PyErr_Format(PyExc_ValueError, "Output buffer too small, %zd samples needed",
+          olength);
+        goto e1;
+    }
+    if (((uintptr_t)oview.buf % sizeof(int16_t)) != 0) {
+        PyErr_SetString(PyExc_ValueError, "Output buffer is not aligned for 16-bit samples");
+        goto e1;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->dec_lock, WAIT_LOCK);
+    g722_decode(self->g722_dctx, (const uint8_t *)iview.buf, length, (int16_t *)oview.buf);
+    PyThread_release_lock(self->dec_lock);
+    if (swap) {
+        uint16_t *op = (uint16_t *)oview.buf;
+
+        for (i = 0; i < olength; i++) {
+            op[i] = (uint16_t)((op[i] << 8) | (op[i] >> 8));
+        }
+    }
+    Py_END_ALLOW_THREADS
+    rval = PyLong_FromSsize_t(olength);
+e1:
+    PyBuffer_Release(&oview);
+e0:
+    PyBuffer_Release(&iview);
+    return rval;
+}
+
+// Payloads of up to this many packets are held without an allocation
+#define PACKETS_ON_STACK 32
+
+// The decode_packets method for PyG722 objects: a jitter buffer's worth of
+// payloads decoded back to back in one call, with the offset of each in the
+// samples
+static PyObject *
+PyG722_decode_packets(PyG722* self, PyObject *const *args, Py_ssize_t nargs) {
+    Py_buffer small[PACKETS_ON_STACK], *views;
+    long long small_offs[PACKETS_ON_STACK + 1], *offs;
+    PyObject *seq, *item, *samples, *offsets, *rval = NULL;
+    Py_ssize_t n, i, nheld, total;
+    int16_t *array;
+    int k;
+
+    if (!check_nargs("decode_packets", nargs, 1, 1)) {
+        return NULL;
+    }
+    if ((seq = PySequence_Fast(args[0], "Expected a sequence of payloads")) == NULL) {
+        return NULL;
+    }
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (n <= PACKETS_ON_STACK) {
+        views = small;
+        offs = small_offs;
+    } else {
+        views = (Py_buffer *)malloc(n * sizeof(views[0]));
+        offs = (long long *)malloc((n + 1) * sizeof(offs[0]));
+        if (views == NULL || offs == NULL) {
+            free(views);
+            free(offs);
+            Py_DECREF(seq);
+            return PyErr_NoMemory();
+        }
+    }
+    k = (self->sample_rate == 8000) ? 1 : 2;
+    total = 0;
+    for (nheld = 0; nheld < n; nheld++) {
+        item = PySequence_Fast_GET_ITEM(seq, nheld);
+        // Bytes, as a socket hands them out, skip the buffer protocol
+        if (PyBytes_CheckExact(item)) {
+            PyBuffer_FillInfo(&views[nheld], item, PyBytes_AS_STRING(item), PyBytes_GET_SIZE(item), 1,
+              PyBUF_SIMPLE);
+        } else if (PyObject_GetBuffer(item, &views[nheld], PyBUF_SIMPLE) < 0) {
+            goto e0;
+        }
+        if (views[nheld].len > INT_MAX) {
+            PyBuffer_Release(&views[nheld]);
+            PyErr_SetString(PyExc_ValueError, "Payload is too long");
+            goto e0;
+        }
+        offs[nheld] = total;
+        total += views[nheld].len * k;
+    }
+    offs[n] = total;
+    array = (int16_t *)malloc(total ? total * sizeof(array[0]) : 1);
+    if (array == NULL) {
+        PyErr_NoMemory();
+        goto e0;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->dec_lock, WAIT_LOCK);
+    for (i = 0; i < n; i++) {
+        g722_decode(self->g722_dctx, (const uint8_t *)views[i].buf, (int)views[i].len, array + offs[i]);
+    }
+    PyThread_release_lock(self->dec_lock);
+    Py_END_ALLOW_THREADS
+    if ((samples = build_pcm16_result(self, array, total)) == NULL) {
+        goto e0;
+    }
+    if ((offsets = build_typed_array("q", offs, (n + 1) * sizeof(offs[0]))) == NULL) {
+        Py_DECREF(samples);
+        goto e0;
+    }
+    rval = PyTuple_Pack(2, samples, offsets);
+    Py_DECREF(samples);
+    Py_DECREF(offsets);
+e0:
+    for (i = 0; i < nheld; i++) {
+        PyBuffer_Release(&views[i]);
+    }
+    if (views != small) {
+        free(views);
+        free(offs);
+    }
+    Py_DECREF(seq);
+    return rval;
+}
+
+// The encode_frames method for PyG722 objects: a burst of frames encoded in
+// one call, with the offset of each frame's payload in the output
+static PyObject *
+PyG722_encode_frames(PyG722* self, PyObject *const *args, Py_ssize_t nargs) {
+    PyObject *obuf_obj, *offsets, *rval;
+    struct pcm_input in;
+    Py_ssize_t frame_len, frame_bytes, olength, nframes, i;
+    long long *offs;
+
+    if (!check_nargs("encode_frames", nargs, 2, 2)) {
+        return NULL;
+    }
+    frame_len = PyNumber_AsSsize_t(args[1], PyExc_OverflowError);
+    if (frame_len == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    // A frame is a whole number of codes
+    if (frame_len <= 0 || (self->sample_rate != 8000 && frame_len % 2 != 0)) {
+        PyErr_SetString(PyExc_ValueError, "frame_len must be positive, and even at 16000");
+        return NULL;
+    }
+    if (pcm_input_get(self->numpy_api, args[0], &in) < 0) {
+        return NULL;
+    }
+    olength = self->sample_rate == 8000 ? in.length : in.length / 2;
+    frame_bytes = self->sample_rate == 8000 ? frame_len : frame_len / 2;
+    // The last frame may be short
+    nframes = olength / frame_bytes + (olength % frame_bytes != 0);
+    obuf_obj = PyBytes_FromStringAndSize(NULL, olength);
+    offs = (long long *)malloc((nframes + 1) * sizeof(offs[0]));
+    if (obuf_obj == NULL || offs == NULL) {
+        Py_XDECREF(obuf_obj);
+        free(offs);
+        pcm_input_release(&in);
+        return PyErr_NoMemory();
+    }
+    encode_locked(self, &in, (uint8_t *)PyBytes_AS_STRING(obuf_obj));
+    pcm_input_release(&in);
+    for (i = 0; i < nframes; i++) {
+        offs[i] = i * frame_bytes;
+    }
+    offs[nframes] = olength;
+    offsets = build_typed_array("q", offs, (nframes + 1) * sizeof(offs[0]));
+    free(offs);
+    if (offsets == NULL) {
+        Py_DECREF(obuf_obj);
+        return NULL;
+    }
+    rval = PyTuple_Pack(2, obuf_obj, offsets);
+    Py_DECREF(obuf_obj);
+    Py_DECREF(offsets);
+    return rval;
+}
+
+// Bytes read from a stream at a time unless the caller says otherwise
+#define STREAM_CHUNK 65536
+
+// A file-like source read through readinto() into one reused buffer, so a
+// stream of any length is coded in constant memory
+struct pcm_stream {
+    PyG722 *self;
+    PyObject *src;
+    PyObject *ibuf;
+    Py_ssize_t chunk;
+    Py_ssize_t have;
+    bool encode;
+    bool swap;
+    bool eof;
+};
+
+static int
+pcm_stream_init(struct pcm_stream *st, PyG722 *self, PyObject *src, bool encode,
+  Py_ssize_t chunk, const char *byteorder)
+{
+    memset(st, 0, sizeof(*st));
+    // Whole samples, and pairs of them at 16k, so that nothing is left over
+    if (chunk < 4 || chunk > INT_MAX / 4) {
+        PyErr_SetString(PyExc_ValueError, "chunk must be at least 4 bytes, and fit an int when decoded");
+        return -1;
+    }
+    if (strcmp(byteorder, "little") == 0) {
+        st->swap = !host_is_little_endian();
+    } else if (strcmp(byteorder, "big") == 0) {
+        st->swap = host_is_little_endian();
+    } else {
+        PyErr_SetString(PyExc_ValueError, "byteorder must be either 'little' or 'big'");
+        return -1;
+    }
+    st->ibuf = PyByteArray_FromStringAndSize(NULL, chunk);
+    if (st->ibuf == NULL) {
+        return -1;
+    }
+    st->self = self;
+    st->src = src;
+    st->chunk = chunk;
+    st->encode = encode;
+    return 0;
+}
+
+static void
+pcm_stream_release(struct pcm_stream *st)
+{
+    Py_CLEAR(st->ibuf);
+}
+
+// A slice of a bytearray, as a memoryview to pass to readinto() or write()
+static PyObject *
+bytearray_view(PyObject *ba, Py_ssize_t start, Py_ssize_t stop)
+{
+    PyObject *mv, *view;
+
+    if ((mv = PyMemoryView_FromObject(ba)) == NULL) {
+        return NULL;
+    }
+    view = PySequence_GetSlice(mv, start, stop);
+    Py_DECREF(mv);
+    return view;
+}
+
+// Read until there is at least one unit to code, returning the bytes that
+// make whole units, 0 at the end of the stream or -1 on error
+static Py_ssize_t
+pcm_stream_read(struct pcm_stream *st)
+{
+    Py_ssize_t unit, n;
+    PyObject *view, *rval;
+
+    if (!st->encode) {
+        unit = 1;
+    } else {
+        unit = (st->self->sample_rate == 8000) ? 2 : 4;
+    }
+    while (!st->eof && st->have < unit) {
+        if ((view = bytearray_view(st->ibuf, st->have, st->chunk)) == NULL) {
+            return -1;
+        }
+        rval = PyObject_CallMethod(st->src, "readinto", "O", view);
+        Py_DECREF(view);
+        if (rval == NULL) {
+            return -1;
+        }
+        if (rval == Py_None) {
+            Py_DECREF(rval);
+            PyErr_SetString(PyExc_BlockingIOError, "Source stream has no data ready");
+            return -1;
+        }
+        n = PyNumber_AsSsize_t(rval, PyExc_OverflowError);
+        Py_DECREF(rval);
+        if (n == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+        if (n < 0 || n > st->chunk - st->have) {
+            PyErr_SetString(PyExc_ValueError, "readinto() returned an invalid length");
+            return -1;
+        }
+        st->have += n;
+        st->eof = (n == 0);
+    }
+    return st->have - st->have % unit;
+}
+
+// The bytes or samples that coding n bytes read gives
+static Py_ssize_t
+pcm_stream_olength(const struct pcm_stream *st, Py_ssize_t n)
+{
+    if (st->encode) {
+        return (st->self->sample_rate == 8000) ? n / 2 : n / 4;
+    }
+    return (st->self->sample_rate == 8000) ? n : n * 2;
+}
+
+// Code the n bytes at the front of the buffer into out, with the GIL
+// released, and keep whatever is left over for the next read
+static void
+pcm_stream_code(struct pcm_stream *st, Py_ssize_t n, void *out, bool swap_out)
+{
+    PyG722 *self = st->self;
+    uint8_t *ibuf = (uint8_t *)PyByteArray_AS_STRING(st->ibuf);
+    Py_ssize_t i, olength;
+
+    olength = pcm_stream_olength(st, n);
+    Py_BEGIN_ALLOW_THREADS
+    if (st->encode) {
+        int16_t *pcm = (int16_t *)ibuf;
+
+        if (st->swap) {
+            for (i = 0; i < n / 2; i++) {
+                pcm[i] = (int16_t)load_i16(ibuf + 2 * i, !host_is_little_endian());
+            }
+        }
+        PyThread_acquire_lock(self->enc_lock, WAIT_LOCK);
+        g722_encode(self->g722_ectx, pcm, (int)(n / 2), (uint8_t *)out);
+        PyThread_release_lock(self->enc_lock);
+    } else {
+        uint16_t *op = (uint16_t *)out;
+
+        PyThread_acquire_lock(self->dec_lock, WAIT_LOCK);
+        g722_decode(self->g722_dctx, ibuf, (int)n, (int16_t *)out);
+        PyThread_release_lock(self->dec_lock);
+        if (swap_out) {
+            for (i = 0; i < olength; i++) {
+                op[i] = (uint16_t)((op[i] << 8) | (op[i] >> 8));
+            }
+        }
+    }
+    st->have -= n;
+    memmove(ibuf, ibuf + n, st->have);
+    Py_END_ALLOW_THREADS
+}
+
+// Write all of the first n bytes of a bytearray, however many calls it takes
+static int
+stream_write_all(PyObject *dst, PyObject *obuf, Py_ssize_t n)
+{
+    Py_ssize_t off, w;
+    PyObject *view, *rval;
+
+    for (off = 0; off < n; off += w) {
+        if ((view = bytearray_view(obuf, off, n)) == NULL) {
+            return -1;
+        }
+        rval = PyObject_CallMethod(dst, "write", "O", view);
+        Py_DECREF(view);
+        if (rval == NULL) {
+            return -1;
+        }
+        // Writers that return nothing are taken to have written it all
+        if (rval == Py_None) {
+            Py_DECREF(rval);
+            break;
+        }
+        w = PyNumber_AsSsize_t(rval, PyExc_OverflowError);
+        Py_DECREF(rval);
+        if (w == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+        if (w <= 0 || w > n - off) {
+            PyErr_SetString(PyExc_OSError, "write() returned an invalid length");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// encode_stream() and decode_stream(): from one file-like object to another
+static PyObject *
+pcm_stream_copy(PyG722 *self, PyObject *args, PyObject *kwds, bool encode)
+{
+    static char *kwlist[] = {"src", "dst", "chunk", "byteorder", NULL};
+    PyObject *src, *dst, *obuf;
+    Py_ssize_t chunk = STREAM_CHUNK, n, olength, total;
+    const char *byteorder = "little";
+    struct pcm_stream st;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|ns", kwlist, &src, &dst, &chunk, &byteorder)) {
+        return NULL;
+    }
+    if (pcm_stream_init(&st, self, src, encode, chunk, byteorder) < 0) {
+        return NULL;
+    }
+    olength = pcm_stream_olength(&st, chunk);
+    obuf = PyByteArray_FromStringAndSize(NULL, encode ? olength : olength * (Py_ssize_t)sizeof(int16_t));
+    if (obuf == NULL) {
+        pcm_stream_release(&st);
+        return NULL;
+    }
+    total = 0;
+    while ((n = pcm_stream_read(&st)) > 0) {
+        olength = pcm_stream_olength(&st, n);
+        pcm_stream_code(&st, n, PyByteArray_AS_STRING(obuf), st.swap);
+        if (stream_write_all(dst, obuf, encode ? olength : olength * (Py_ssize_t)sizeof(int16_t)) < 0) {
+            n = -1;
+            break;
+        }
+        total += olength;
+    }
+    Py_DECREF(obuf);
+    pcm_stream_release(&st);
+    if (n < 0) {
+        return NULL;
+    }
+    return PyLong_FromSsize_t(total);
+}
+
+static PyObject *
+PyG722_encode_stream(PyG722* self, PyObject* args, PyObject* kwds) {
+    return pcm_stream_copy(self, args, kwds, true);
+}
+
+static PyObject *
+PyG722_decode_stream(PyG722* self, PyObject* args, PyObject* kwds) {
+    return pcm_stream_copy(self, args, kwds, false);
+}
+
+// iter_encode() and iter_decode(): a chunk of output for each step
+typedef struct {
+    PyObject_HEAD
+    struct pcm_stream st;
+    // A step calls back into Python, so only one may run at a time
+    PyThread_type_lock busy;
+} PyG722StreamIter;
+
+// The iterator holds the source and the codec, either of which may hold it
+static int
+PyG722StreamIter_traverse(PyG722StreamIter *it, visitproc visit, void *arg) {
+    Py_VISIT(it->st.src);
+    Py_VISIT((PyObject *)it->st.self);
+    return 0;
+}
+
+static int
+PyG722StreamIter_clear(PyG722StreamIter *it) {
+    Py_CLEAR(it->st.src);
+    Py_CLEAR(it->st.self);
+    return 0;
+}
+
+static void
+PyG722StreamIter_dealloc(PyG722StreamIter *it) {
+    PyObject_GC_UnTrack(it);
+    pcm_stream_release(&it->st);
+    PyG722StreamIter_clear(it);
+    if (it->busy != NULL)
+        PyThread_free_lock(it->busy);
+    Py_TYPE(it)->tp_free((PyObject *)it);
+}
+
+static PyObject *
+PyG722StreamIter_next(PyG722StreamIter *it) {
+    struct pcm_stream *st = &it->st;
+    PyObject *rval = NULL;
+    int16_t *array;
+    Py_ssize_t n, olength;
+
+    if (!PyThread_acquire_lock(it->busy, NOWAIT_LOCK)) {
+        PyErr_SetString(PyExc_ValueError, "Stream iterator already executing");
+        return NULL;
+    }
+    // Once cleared by the garbage collector there is nothing left to read
+    if (st->src == NULL || (n = pcm_stream_read(st)) <= 0) {
+        // NULL with no exception set is the end of the iteration
+        goto out;
+    }
+    olength = pcm_stream_olength(st, n);
+    if (st->encode) {
+        if ((rval = PyBytes_FromStringAndSize(NULL, olength)) != NULL) {
+            pcm_stream_code(st, n, PyBytes_AS_STRING(rval), false);
+        }
+    } else {
+        if ((array = (int16_t *)malloc(olength * sizeof(array[0]))) == NULL) {
+            PyErr_NoMemory();
+            goto out;
+        }
+        pcm_stream_code(st, n, array, false);
+        rval = build_pcm16_result(st->self, array, olength);
+    }
+out:
+    PyThread_release_lock(it->busy);
+    return rval;
+}
+
+static PyTypeObject PyG722StreamIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = MODULE_NAME_STR ".StreamIterator",
+    .tp_doc = "Iterator coding a file-like object a chunk at a time.",
+    .tp_basicsize = sizeof(PyG722StreamIter),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_dealloc = (destructor)PyG722StreamIter_dealloc,
+    .tp_traverse = (traverseproc)PyG722StreamIter_traverse,
+    .tp_clear = (inquiry)PyG722StreamIter_clear,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)PyG722StreamIter_next,
+};
+
+static PyObject *
+pcm_stream_iter(PyG722 *self, PyObject *args, PyObject *kwds, bool encode)
+{
+    static char *enc_kwlist[] = {"src", "chunk", "byteorder", NULL};
+    static char *dec_kwlist[] = {"src", "chunk", NULL};
+    PyObject *src;
+    Py_ssize_t chunk = STREAM_CHUNK;
+    const char *byteorder = "little";
+    PyG722StreamIter *it;
+
+    if (encode) {
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ns", enc_kwlist, &src, &chunk, &byteorder)) {
             return NULL;
         }
-        return self->numpy_api->from_pcm16_owned(array, olength);
+    } else if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|n", dec_kwlist, &src, &chunk)) {
+        return NULL;
     }
-    return build_pcm16_array(array, olength);
+    it = PyObject_GC_New(PyG722StreamIter, &PyG722StreamIterType);
+    if (it == NULL) {
+        return NULL;
+    }
+    memset(&it->st, 0, sizeof(it->st));
+    if ((it->busy = PyThread_allocate_lock()) == NULL) {
+        Py_DECREF(it);
+        return PyErr_NoMemory();
+    }
+    if (pcm_stream_init(&it->st, self, src, encode, chunk, byteorder) < 0) {
+        Py_DECREF(it);
+        return NULL;
+    }
+    Py_INCREF(src);
+    Py_INCREF(self);
+    PyObject_GC_Track(it);
+    return (PyObject *)it;
+}
+
+static PyObject *
+PyG722_iter_encode(PyG722* self, PyObject* args, PyObject* kwds) {
+    return pcm_stream_iter(self, args, kwds, true);
+}
+
+static PyObject *
+PyG722_iter_decode(PyG722* self, PyObject* args, PyObject* kwds) {
+    return pcm_stream_iter(self, args, kwds, false);
 }
 
 static PyMethodDef PyG722_methods[] = {
-    {"encode", (PyCFunction)PyG722_encode, METH_VARARGS, "Encode signed linear PCM samples to G.722 format"},
-    {"decode", (PyCFunction)PyG722_decode, METH_VARARGS, "Decode G.722 format to signed linear PCM samples"},
+    {"encode", (PyCFunction)(void(*)(void))PyG722_encode, METH_FASTCALL, "Encode signed linear PCM samples to G.722 format"},
+    {"decode", (PyCFunction)(void(*)(void))PyG722_decode, METH_FASTCALL, "Decode G.722 format to signed linear PCM samples"},
+    {"encode_into", (PyCFunction)(void(*)(void))PyG722_encode_into, METH_FASTCALL,
+      "Encode signed linear PCM samples into a writable buffer, returning the number of bytes written"},
+    {"decode_into", (PyCFunction)(void(*)(void))PyG722_decode_into, METH_FASTCALL,
+      "Decode G.722 format into a writable buffer of 16-bit samples, returning the number of samples written"},
+    {"decode_packets", (PyCFunction)(void(*)(void))PyG722_decode_packets, METH_FASTCALL,
+      "Decode a sequence of G.722 payloads back to back, returning the samples and an array('q') "
+      "of the offset of each payload's samples, and of the end"},
+    {"encode_frames", (PyCFunction)(void(*)(void))PyG722_encode_frames, METH_FASTCALL,
+      "Encode signed linear PCM samples as frames of frame_len samples, returning the payloads "
+      "back to back and an array('q') of the offset of each frame's payload, and of the end"},
+    {"encode_stream", (PyCFunction)(void(*)(void))PyG722_encode_stream, METH_VARARGS | METH_KEYWORDS,
+      "Encode 16-bit PCM read from a file-like object a chunk at a time, writing G.722 to another, "
+      "returning the number of bytes written"},
+    {"decode_stream", (PyCFunction)(void(*)(void))PyG722_decode_stream, METH_VARARGS | METH_KEYWORDS,
+      "Decode G.722 read from a file-like object a chunk at a time, writing 16-bit PCM to another, "
+      "returning the number of samples written"},
+    {"iter_encode", (PyCFunction)(void(*)(void))PyG722_iter_encode, METH_VARARGS | METH_KEYWORDS,
+      "Iterate over the G.722 encoding of 16-bit PCM read from a file-like object, a chunk at a time"},
+    {"iter_decode", (PyCFunction)(void(*)(void))PyG722_iter_decode, METH_VARARGS | METH_KEYWORDS,
+      "Iterate over the decoding of G.722 read from a file-like object, a chunk at a time"},
     {NULL}  // Sentinel
 };
 
@@ -472,11 +1176,362 @@ static PyTypeObject PyG722Type = {
     .tp_methods = PyG722_methods,
 };
 
+// encode_batch() and decode_batch(): many channels of the same length, each
+// on its own context, with the rows spread over a native thread pool
+struct batch_input {
+    // The rows, when given as a sequence rather than one 2-D buffer
+    PyObject *rows;
+    struct pcm_input *pcm;
+    Py_buffer *views;
+    // How many rows of pcm or views are held
+    Py_ssize_t nheld;
+    Py_buffer view;
+    bool from_2d;
+    // A 2-D buffer of samples in the other byte order, swapped
+    int16_t *copy;
+    const void **row;
+    Py_ssize_t nrows;
+    Py_ssize_t len;
+};
+
+static void
+batch_input_release(struct batch_input *in)
+{
+    Py_ssize_t i;
+
+    if (in->pcm != NULL) {
+        for (i = 0; i < in->nheld; i++) {
+            pcm_input_release(&in->pcm[i]);
+        }
+        free(in->pcm);
+    }
+    if (in->views != NULL) {
+        for (i = 0; i < in->nheld; i++) {
+            PyBuffer_Release(&in->views[i]);
+        }
+        free(in->views);
+    }
+    if (in->from_2d) {
+        PyBuffer_Release(&in->view);
+    }
+    free(in->copy);
+    free(in->row);
+    Py_XDECREF(in->rows);
+}
+
+static bool
+is_u8_buffer_format(const char *format)
+{
+    return format == NULL || strcmp(format, "B") == 0 || strcmp(format, "b") == 0
+        || strcmp(format, "c") == 0;
+}
+
+static int
+batch_input_get(const G722NumpyAPI *numpy_api, PyObject *obj, bool encode, struct batch_input *in)
+{
+    Py_ssize_t i, len;
+
+    memset(in, 0, sizeof(*in));
+    if (PyObject_CheckBuffer(obj) &&
+        PyObject_GetBuffer(obj, &in->view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0) {
+        if (in->view.ndim == 2 && (encode ?
+          (in->view.itemsize == (Py_ssize_t)sizeof(int16_t) && is_i16_buffer_format(in->view.format)) :
+          (in->view.itemsize == 1 && is_u8_buffer_format(in->view.format)))) {
+            in->from_2d = true;
+            in->nrows = in->view.shape[0];
+            in->len = in->view.shape[1];
+        } else {
+            PyBuffer_Release(&in->view);
+        }
+    } else {
+        PyErr_Clear();
+    }
+    if (!in->from_2d) {
+        if ((in->rows = PySequence_Tuple(obj)) == NULL) {
+            PyErr_SetString(PyExc_TypeError,
+              "Expected a 2-D C-contiguous buffer or a sequence of 1-D buffers");
+            return -1;
+        }
+        in->nrows = PyTuple_GET_SIZE(in->rows);
+    }
+    if ((in->row = (const void **)malloc((in->nrows ? in->nrows : 1) * sizeof(in->row[0]))) == NULL) {
+        PyErr_NoMemory();
+        goto e0;
+    }
+    if (in->from_2d) {
+        const uint8_t *buf = (const uint8_t *)in->view.buf;
+        Py_ssize_t rowbytes = in->len * in->view.itemsize;
+
+        if (encode && !i16_buffer_format_is_native(in->view.format)) {
+            bool src_is_little = i16_buffer_format_is_little_endian(in->view.format);
+
+            if ((in->copy = (int16_t *)malloc(in->view.len ? in->view.len : 1)) == NULL) {
+                PyErr_NoMemory();
+                goto e0;
+            }
+            for (i = 0; i < in->view.len / 2; i++) {
+                in->copy[i] = load_i16(buf + 2 * i, src_is_little);
+            }
+            buf = (const uint8_t *)in->copy;
+        }
+        for (i = 0; i < in->nrows; i++) {
+            in->row[i] = buf + i * rowbytes;
+        }
+        return 0;
+    }
+
+    if (encode) {
+        in->pcm = (struct pcm_input *)calloc(in->nrows ? in->nrows : 1, sizeof(in->pcm[0]));
+    } else {
+        in->views = (Py_buffer *)calloc(in->nrows ? in->nrows : 1, sizeof(in->views[0]));
+    }
+    if (in->pcm == NULL && in->views == NULL) {
+        PyErr_NoMemory();
+        goto e0;
+    }
+    for (i = 0; i < in->nrows; i++) {
+        PyObject *item = PyTuple_GET_ITEM(in->rows, i);
+
+        if (encode) {
+            if (pcm_input_get(numpy_api, item, &in->pcm[i]) < 0) {
+                goto e0;
+            }
+            in->row[i] = in->pcm[i].array;
+            len = in->pcm[i].length;
+        } else {
+            if (PyObject_GetBuffer(item, &in->views[i], PyBUF_SIMPLE) < 0) {
+                goto e0;
+            }
+            in->row[i] = in->views[i].buf;
+            len = in->views[i].len;
+        }
+        in->nheld = i + 1;
+        if (i == 0) {
+            in->len = len;
+        } else if (len != in->len) {
+            PyErr_Format(PyExc_ValueError, "Row %zd is %zd long, not %zd as row 0 is", i, len, in->len);
+            goto e0;
+        }
+    }
+    return 0;
+e0:
+    batch_input_release(in);
+    return -1;
+}
+
+// Code every row into its own output, with a context of its own. Runs
+// without the GIL.
+static int
+batch_code(bool encode, int sample_rate, int bit_rate, int threads, const void **row,
+  Py_ssize_t nrows, Py_ssize_t len, void **out)
+{
+    struct g722_job *jobs;
+    G722_ENGINE *e;
+    Py_ssize_t i;
+    int options, rval;
+
+    options = (sample_rate == 8000) ? G722_SAMPLE_RATE_8000 : G722_DEFAULT;
+    if ((jobs = (struct g722_job *)calloc(nrows ? nrows : 1, sizeof(jobs[0]))) == NULL) {
+        return -1;
+    }
+    rval = -1;
+    for (i = 0; i < nrows; i++) {
+        jobs[i].op = encode ? G722_JOB_ENCODE : G722_JOB_DECODE;
+        jobs[i].ctx = encode ? (void *)g722_encoder_new(bit_rate, options) :
+          (void *)g722_decoder_new(bit_rate, options);
+        if (jobs[i].ctx == NULL) {
+            goto out;
+        }
+        jobs[i].in = row[i];
+        jobs[i].len = (int)len;
+        jobs[i].out = out[i];
+    }
+    // One worker per CPU, but no more of them than rows to give them
+    if (threads == 0) {
+        threads = g722_engine_cpus();
+    }
+    if (nrows == 0 || len == 0) {
+        rval = 0;
+    } else if (threads == 1 || nrows == 1) {
+        for (i = 0; i < nrows; i++) {
+            if (encode) {
+                g722_encode(jobs[i].ctx, jobs[i].in, jobs[i].len, jobs[i].out);
+            } else {
+                g722_decode(jobs[i].ctx, jobs[i].in, jobs[i].len, jobs[i].out);
+            }
+        }
+        rval = 0;
+    } else {
+        // The workers come and go with the call, so leave them unpinned
+        if ((e = g722_engine_new((threads > nrows) ? (int)nrows : threads, G722_ENGINE_NO_PIN)) != NULL) {
+            rval = g722_engine_run(e, jobs, (int)nrows);
+            g722_engine_destroy(e);
+        }
+    }
+out:
+    for (i = 0; i < nrows && jobs[i].ctx != NULL; i++) {
+        if (encode) {
+            g722_encoder_destroy(jobs[i].ctx);
+        } else {
+            g722_decoder_destroy(jobs[i].ctx);
+        }
+    }
+    free(jobs);
+    return rval;
+}
+
+static PyObject *
+g722_batch(PyObject *args, PyObject *kwds, bool encode)
+{
+    static char *kwlist[] = {"data", "sample_rate", "bit_rate", "threads", "use_numpy", NULL};
+    PyObject *data, *use_numpy_obj = Py_None, *numpy_module = NULL, *rval = NULL;
+    const G722NumpyAPI *numpy_api = NULL;
+    struct batch_input in;
+    int sample_rate, bit_rate, threads = 0, use_numpy = -1, rc;
+    Py_ssize_t olen, osize, itemsize, i;
+    uint8_t *block = NULL;
+    void **out = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oii|iO", kwlist, &data, &sample_rate, &bit_rate,
+      &threads, &use_numpy_obj)) {
+        return NULL;
+    }
+    if (sample_rate != 8000 && sample_rate != 16000) {
+        PyErr_SetString(PyExc_ValueError, "Sample rate must be 8000 or 16000");
+        return NULL;
+    }
+    if (bit_rate != 48000 && bit_rate != 56000 && bit_rate != 64000) {
+        PyErr_SetString(PyExc_ValueError, "Bit rate must be 48000, 56000 or 64000");
+        return NULL;
+    }
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must be 0, for one per CPU, or more");
+        return NULL;
+    }
+    if (use_numpy_obj != Py_None && (use_numpy = PyObject_IsTrue(use_numpy_obj)) < 0) {
+        return NULL;
+    }
+    if (use_numpy != 0 && load_numpy_api(&numpy_api, &numpy_module, use_numpy > 0) < 0) {
+        return NULL;
+    }
+    if (batch_input_get(numpy_api, data, encode, &in) < 0) {
+        goto e0;
+    }
+    if (in.len > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Rows are too long");
+        goto e1;
+    }
+    if (encode) {
+        olen = (sample_rate == 8000) ? in.len : in.len / 2;
+        itemsize = 1;
+    } else {
+        olen = (sample_rate == 8000) ? in.len : in.len * 2;
+        itemsize = sizeof(int16_t);
+    }
+    if ((out = (void **)calloc(in.nrows ? in.nrows : 1, sizeof(out[0]))) == NULL) {
+        PyErr_NoMemory();
+        goto e1;
+    }
+    // One block for a 2-D NumPy array to take over, or else a list of rows
+    // as encode() and decode() return them
+    if (numpy_api != NULL) {
+        if (in.nrows != 0 && olen > PY_SSIZE_T_MAX / itemsize / in.nrows) {
+            PyErr_NoMemory();
+            goto e1;
+        }
+        osize = in.nrows * olen * itemsize;
+        if ((block = (uint8_t *)malloc(osize ? osize : 1)) == NULL) {
+            PyErr_NoMemory();
+            goto e1;
+        }
+        for (i = 0; i < in.nrows; i++) {
+            out[i] = block + i * olen * itemsize;
+        }
+    } else {
+        if ((rval = PyList_New(in.nrows)) == NULL) {
+            goto e1;
+        }
+        for (i = 0; i < in.nrows; i++) {
+            if (encode) {
+                PyObject *row = PyBytes_FromStringAndSize(NULL, olen);
+
+                if (row == NULL) {
+                    goto e2;
+                }
+                PyList_SET_ITEM(rval, i, row);
+                out[i] = PyBytes_AS_STRING(row);
+            } else if ((out[i] = malloc(olen ? olen * itemsize : 1)) == NULL) {
+                PyErr_NoMemory();
+                goto e2;
+            }
+        }
+    }
+    Py_BEGIN_ALLOW_THREADS
+    rc = batch_code(encode, sample_rate, bit_rate, threads, in.row, in.nrows, in.len, out);
+    Py_END_ALLOW_THREADS
+    if (rc < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Error running the G.722 batch");
+        goto e2;
+    }
+    if (numpy_api != NULL) {
+        rval = numpy_api->from_owned_2d(block, in.nrows, olen, (int)itemsize);
+        block = NULL;
+    } else if (!encode) {
+        for (i = 0; i < in.nrows; i++) {
+            PyObject *row = build_pcm16_array((int16_t *)out[i], olen);
+
+            out[i] = NULL;
+            if (row == NULL) {
+                goto e2;
+            }
+            PyList_SET_ITEM(rval, i, row);
+        }
+    }
+    goto e1;
+e2:
+    Py_CLEAR(rval);
+e1:
+    if (out != NULL && numpy_api == NULL && !encode) {
+        for (i = 0; i < in.nrows; i++) {
+            free(out[i]);
+        }
+    }
+    free(out);
+    free(block);
+    batch_input_release(&in);
+e0:
+    Py_XDECREF(numpy_module);
+    return rval;
+}
+
+static PyObject *
+G722_encode_batch(PyObject *module, PyObject *args, PyObject *kwds) {
+    (void)module;
+    return g722_batch(args, kwds, true);
+}
+
+static PyObject *
+G722_decode_batch(PyObject *module, PyObject *args, PyObject *kwds) {
+    (void)module;
+    return g722_batch(args, kwds, false);
+}
+
+static PyMethodDef G722_module_methods[] = {
+    {"encode_batch", (PyCFunction)(void(*)(void))G722_encode_batch, METH_VARARGS | METH_KEYWORDS,
+      "Encode the rows of a 2-D array of 16-bit PCM, each a channel with an encoder of its own, "
+      "on a pool of native threads, returning a 2-D array of G.722, or a list of rows without NumPy"},
+    {"decode_batch", (PyCFunction)(void(*)(void))G722_decode_batch, METH_VARARGS | METH_KEYWORDS,
+      "Decode the rows of a 2-D array of G.722, each a channel with a decoder of its own, "
+      "on a pool of native threads, returning a 2-D array of 16-bit PCM, or a list of rows without NumPy"},
+    {NULL}  // Sentinel
+};
+
 static struct PyModuleDef G722_module = {
     PyModuleDef_HEAD_INIT,
     .m_name = MODULE_NAME_STR,
     .m_doc = "Python interface for the ITU-T G.722 audio codec.",
     .m_size = -1,
+    .m_methods = G722_module_methods,
 };
 
 // Module initialization function
@@ -484,6 +1539,8 @@ PyMODINIT_FUNC PY_INIT_FUNC(void) {
     PyObject* module;
     if (PyType_Ready(&PyG722Type) < 0)
         return NULL;
+    if (PyType_Ready(&PyG722StreamIterType) < 0)
+        return NULL;
 
     module = PyModule_Create(&G722_module);
     if (module == NULL)
@@ -4,11 +4,17 @@
 #include <stdint.h>
 #include <Python.h>
 
+// New members only ever go on the end, and size says which the addon has
 typedef struct {
+    // sizeof(G722NumpyAPI) in the addon
+    size_t size;
     int (*check_int16_1d)(PyObject *item, int16_t **array, Py_ssize_t *length);
     PyObject *(*from_pcm16_owned)(int16_t *array, Py_ssize_t length);
+    // A (rows, cols) array of int16 for itemsize 2, or of uint8 for 1
+    PyObject *(*from_owned_2d)(void *data, Py_ssize_t rows, Py_ssize_t cols, int itemsize);
 } G722NumpyAPI;
 
-#define G722_NUMPY_CAPSULE_NAME "G722_numpy._C_API"
+// Versioned, as the addons of 1.2.8 and before have neither size nor from_owned_2d
+#define G722_NUMPY_CAPSULE_NAME "G722_numpy._C_API.2"
 
 #endif
@@ -91,6 +91,35 @@ api_from_pcm16_owned(int16_t *array, Py_ssize_t length)
     return numpy_array;
 }
 
+static PyObject *
+api_from_owned_2d(void *data, Py_ssize_t rows, Py_ssize_t cols, int itemsize)
+{
+    PyDataOwner *owner;
+    npy_intp dims[2];
+    PyObject *numpy_array;
+
+    owner = PyObject_New(PyDataOwner, &PyDataOwnerType);
+    if (owner == NULL) {
+        free(data);
+        return PyErr_NoMemory();
+    }
+    owner->data = data;
+
+    dims[0] = (npy_intp)rows;
+    dims[1] = (npy_intp)cols;
+    numpy_array = PyArray_SimpleNewFromData(2, dims, (itemsize == 2) ? NPY_INT16 : NPY_UINT8, data);
+    if (numpy_array == NULL) {
+        Py_DECREF(owner);
+        return NULL;
+    }
+    if (PyArray_SetBaseObject((PyArrayObject *)numpy_array, (PyObject *)owner) < 0) {
+        Py_DECREF(owner);
+        Py_DECREF(numpy_array);
+        return NULL;
+    }
+    return numpy_array;
+}
+
 static PyObject *
 py_pcm16_to_numpy(PyObject *self, PyObject *args)
 {
@@ -160,8 +189,10 @@ PyInit_G722_numpy(void)
     PyObject *module;
     PyObject *capsule;
     static G722NumpyAPI api = {
+        .size = sizeof(G722NumpyAPI),
         .check_int16_1d = api_check_int16_1d,
         .from_pcm16_owned = api_from_pcm16_owned,
+        .from_owned_2d = api_from_owned_2d,
     };
 
     import_array();
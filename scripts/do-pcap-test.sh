@@ -0,0 +1,40 @@
+#!/bin/sh
+
+set -e
+set -x
+
+PCAP_CMD="${1:-"./g722_pcap"}"
+TOOL_CMD="${2:-"./g722"}"
+MDIR="${3:-"`dirname ${0}`/.."}"
+TDDIR="${MDIR}/test_data"
+
+# rtp.pcapng: stream a001 is the first 50 frames of test.g722 on a VLAN,
+# reordered, with a duplicate and wrapping sequence numbers and timestamps,
+# b002 is fullscale.g722 over IPv6 and c003 the next 50 frames of test.g722,
+# less frame 25. rtp.pcap: stream d004 is a001 again, Linux cooked.
+rm -rf pcap.outdir.out
+mkdir pcap.outdir.out
+${PCAP_CMD} --raw --jobs 2 --outdir pcap.outdir.out ${TDDIR}/rtp.pcapng ${TDDIR}/rtp.pcap
+${TOOL_CMD} --sln16k -o pcap.test.raw.16k.out ${TDDIR}/test.g722
+${TOOL_CMD} --sln16k -o pcap.fullscale.raw.out ${TDDIR}/fullscale.g722
+head -c 32000 pcap.test.raw.16k.out > pcap.a.raw.out
+cmp pcap.a.raw.out pcap.outdir.out/rtp.pcapng.0000a001.raw
+cmp pcap.a.raw.out pcap.outdir.out/rtp.pcap.0000d004.raw
+cmp pcap.fullscale.raw.out pcap.outdir.out/rtp.pcapng.0000b002.raw
+# The lost frame is 20 ms of silence, and the decoder carries on after it
+dd if=${TDDIR}/test.g722 bs=160 skip=50 count=25 > pcap.c.g722.out
+dd if=${TDDIR}/test.g722 bs=160 skip=76 count=24 >> pcap.c.g722.out
+${TOOL_CMD} --sln16k -o pcap.c.raw.out pcap.c.g722.out
+{ head -c 16000 pcap.c.raw.out; dd if=/dev/zero bs=640 count=1; tail -c +16001 pcap.c.raw.out; } \
+  > pcap.c.raw.16k.out
+cmp pcap.c.raw.16k.out pcap.outdir.out/rtp.pcapng.0000c003.raw
+# WAV is the same audio after a 44 byte header
+${PCAP_CMD} --outdir pcap.outdir.out ${TDDIR}/rtp.pcap
+tail -c +45 pcap.outdir.out/rtp.pcap.0000d004.wav | cmp pcap.a.raw.out -
+# Two captures of the same name with the same SSRC would share an output
+mkdir pcap.outdir.out/a
+cp ${TDDIR}/rtp.pcap pcap.outdir.out/a/
+if ${PCAP_CMD} --outdir pcap.outdir.out ${TDDIR}/rtp.pcap pcap.outdir.out/a/rtp.pcap; then
+  exit 1
+fi
+rm -rf pcap.outdir.out
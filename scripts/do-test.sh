@@ -15,3 +15,69 @@ ${TEST_CMD} --enc test.raw.out test.g722.out
 ${TEST_CMD} --sln16k ${TDDIR}/fullscale.g722 fullscale.raw.out
 openssl sha256 -r test.raw.out test.raw.16k.out pcminb.g722.out pcminb.raw.16k.out \
   test.g722.out fullscale.raw.out | diff ${TDDIR}/test.checksum -
+${TEST_CMD} --multi 17 --sln16k ${TDDIR}/test.g722 test.raw.16k.multi.out
+${TEST_CMD} --multi 17 --enc --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.multi.out
+${TEST_CMD} --multi 17 --enc test.raw.out test.g722.multi.out
+cmp test.raw.16k.out test.raw.16k.multi.out
+cmp pcminb.g722.out pcminb.g722.multi.out
+cmp test.g722.out test.g722.multi.out
+${TEST_CMD} --engine 17 --sln16k ${TDDIR}/test.g722 test.raw.16k.engine.out
+${TEST_CMD} --engine 17 --enc --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.engine.out
+${TEST_CMD} --engine 17 --enc test.raw.out test.g722.engine.out
+cmp test.raw.16k.out test.raw.16k.engine.out
+cmp pcminb.g722.out pcminb.g722.engine.out
+cmp test.g722.out test.g722.engine.out
+${TEST_CMD} --init --sln16k ${TDDIR}/test.g722 test.raw.16k.init.out
+${TEST_CMD} --init --enc test.raw.out test.g722.init.out
+cmp test.raw.16k.out test.raw.16k.init.out
+cmp test.g722.out test.g722.init.out
+${TEST_CMD} --clone --sln16k ${TDDIR}/test.g722 test.raw.16k.clone.out
+${TEST_CMD} --clone --enc --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.clone.out
+cmp test.raw.16k.out test.raw.16k.clone.out
+cmp pcminb.g722.out pcminb.g722.clone.out
+${TEST_CMD} --ulaw ${TDDIR}/test.g722 test.ulaw.out
+${TEST_CMD} --alaw ${TDDIR}/test.g722 test.alaw.out
+${TEST_CMD} --enc --clone --ulaw test.ulaw.out test.g722.ulaw.out
+${TEST_CMD} --enc --clone --alaw test.alaw.out test.g722.alaw.out
+${TEST_CMD} --rs48k --sln16k ${TDDIR}/test.g722 test.raw.48k.out
+${TEST_CMD} --enc --rs48k --sln16k test.raw.48k.out test.g722.48k.out
+${TEST_CMD} --rs48k ${TDDIR}/test.g722 test.raw.48k.8k.out
+${TEST_CMD} --enc --rs48k test.raw.48k.8k.out test.g722.48k.8k.out
+openssl sha256 -r test.raw.48k.out test.g722.48k.out test.raw.48k.8k.out \
+  test.g722.48k.8k.out | diff ${TDDIR}/rs48k.checksum -
+${TEST_CMD} --clone --rs48k --sln16k ${TDDIR}/test.g722 test.raw.48k.clone.out
+${TEST_CMD} --clone --enc --rs48k --sln16k test.raw.48k.out test.g722.48k.clone.out
+cmp test.raw.48k.out test.raw.48k.clone.out
+cmp test.g722.48k.out test.g722.48k.clone.out
+${TEST_CMD} --rtp --sln16k ${TDDIR}/test.g722 test.raw.16k.rtp.out
+${TEST_CMD} --rtp --enc --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.rtp.out
+${TEST_CMD} --rtp --enc test.raw.out test.g722.rtp.out
+cmp test.raw.16k.out test.raw.16k.rtp.out
+cmp pcminb.g722.out pcminb.g722.rtp.out
+cmp test.g722.out test.g722.rtp.out
+# Packed at 56k and 48k, at both sample rates, in pieces of odd sizes,
+# each checked against the unpacked codes, packed the long way round
+${TEST_CMD} --enc --rate 56000 --packed test.raw.out test.g722.56k.packed.out
+${TEST_CMD} --rate 56000 --packed test.g722.56k.packed.out test.raw.56k.packed.out
+${TEST_CMD} --enc --rate 56000 --packed --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.56k.packed.out
+${TEST_CMD} --rate 56000 --packed --sln16k --bend pcminb.g722.56k.packed.out pcminb.raw.16k.56k.packed.out
+${TEST_CMD} --enc --rate 48000 --packed test.raw.out test.g722.48k.packed.out
+${TEST_CMD} --rate 48000 --packed test.g722.48k.packed.out test.raw.48k.packed.out
+${TEST_CMD} --enc --rate 48000 --packed --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.48k.packed.out
+${TEST_CMD} --rate 48000 --packed --sln16k --bend pcminb.g722.48k.packed.out pcminb.raw.16k.48k.packed.out
+openssl sha256 -r test.g722.56k.packed.out test.raw.56k.packed.out \
+  pcminb.g722.56k.packed.out pcminb.raw.16k.56k.packed.out test.g722.48k.packed.out \
+  test.raw.48k.packed.out pcminb.g722.48k.packed.out pcminb.raw.16k.48k.packed.out | \
+  diff ${TDDIR}/packed.checksum -
+${TEST_CMD} --rtp --enc --rate 56000 --packed test.raw.out test.g722.56k.packed.rtp.out
+${TEST_CMD} --rtp --rate 56000 --packed test.g722.56k.packed.out test.raw.56k.packed.rtp.out
+${TEST_CMD} --rtp --enc --rate 48000 --packed --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.48k.packed.rtp.out
+${TEST_CMD} --rtp --rate 48000 --packed --sln16k --bend pcminb.g722.48k.packed.out pcminb.raw.16k.48k.packed.rtp.out
+cmp test.g722.56k.packed.out test.g722.56k.packed.rtp.out
+cmp test.raw.56k.packed.out test.raw.56k.packed.rtp.out
+cmp pcminb.g722.48k.packed.out pcminb.g722.48k.packed.rtp.out
+cmp pcminb.raw.16k.48k.packed.out pcminb.raw.16k.48k.packed.rtp.out
+${TEST_CMD} --clone --enc --rate 56000 --packed --sln16k --bend ${TDDIR}/pcminb.dat pcminb.g722.56k.packed.clone.out
+${TEST_CMD} --init --rate 48000 --packed test.g722.48k.packed.out test.raw.48k.packed.init.out
+cmp pcminb.g722.56k.packed.out pcminb.g722.56k.packed.clone.out
+cmp test.raw.48k.packed.out test.raw.48k.packed.init.out
@@ -0,0 +1,45 @@
+#!/bin/sh
+
+set -e
+set -x
+
+TOOL_CMD="${1:-"./g722"}"
+MDIR="${2:-"`dirname ${0}`/.."}"
+TDDIR="${MDIR}/test_data"
+
+# The same runs as do-test.sh, so the outputs match the same checksums
+${TOOL_CMD} -o tool.test.raw.out ${TDDIR}/test.g722
+${TOOL_CMD} --sln16k -o tool.test.raw.16k.out ${TDDIR}/test.g722
+${TOOL_CMD} --enc --sln16k --bend -o tool.pcminb.g722.out ${TDDIR}/pcminb.dat
+${TOOL_CMD} --sln16k --bend -o tool.pcminb.raw.16k.out tool.pcminb.g722.out
+${TOOL_CMD} --enc -o tool.test.g722.out tool.test.raw.out
+${TOOL_CMD} --sln16k -o tool.fullscale.raw.out ${TDDIR}/fullscale.g722
+openssl sha256 -r tool.test.raw.out tool.test.raw.16k.out tool.pcminb.g722.out \
+  tool.pcminb.raw.16k.out tool.test.g722.out tool.fullscale.raw.out | \
+  sed 's| \*tool\.| *|' | diff ${TDDIR}/test.checksum -
+# Packed, a large block at a time, comes to the same as in the odd sized
+# pieces of do-test.sh
+${TOOL_CMD} --enc --rate 56000 --packed -o tool.test.g722.56k.packed.out tool.test.raw.out
+${TOOL_CMD} --rate 56000 --packed -o tool.test.raw.56k.packed.out tool.test.g722.56k.packed.out
+${TOOL_CMD} --enc --rate 56000 --packed --sln16k --bend -o tool.pcminb.g722.56k.packed.out ${TDDIR}/pcminb.dat
+${TOOL_CMD} --rate 56000 --packed --sln16k --bend -o tool.pcminb.raw.16k.56k.packed.out tool.pcminb.g722.56k.packed.out
+${TOOL_CMD} --enc --rate 48000 --packed -o tool.test.g722.48k.packed.out tool.test.raw.out
+${TOOL_CMD} --rate 48000 --packed -o tool.test.raw.48k.packed.out tool.test.g722.48k.packed.out
+${TOOL_CMD} --enc --rate 48000 --packed --sln16k --bend -o tool.pcminb.g722.48k.packed.out ${TDDIR}/pcminb.dat
+${TOOL_CMD} --rate 48000 --packed --sln16k --bend -o tool.pcminb.raw.16k.48k.packed.out tool.pcminb.g722.48k.packed.out
+openssl sha256 -r tool.test.g722.56k.packed.out tool.test.raw.56k.packed.out \
+  tool.pcminb.g722.56k.packed.out tool.pcminb.raw.16k.56k.packed.out tool.test.g722.48k.packed.out \
+  tool.test.raw.48k.packed.out tool.pcminb.g722.48k.packed.out tool.pcminb.raw.16k.48k.packed.out | \
+  sed 's| \*tool\.| *|' | diff ${TDDIR}/packed.checksum -
+# Pipes are read rather than mapped
+cat ${TDDIR}/pcminb.dat | ${TOOL_CMD} --enc --sln16k --bend -o - - > tool.pipe.g722.out
+cmp tool.pcminb.g722.out tool.pipe.g722.out
+# Several files at once, each to its own output
+rm -rf tool.outdir.out
+mkdir tool.outdir.out
+cp ${TDDIR}/test.g722 tool.a.out
+cp ${TDDIR}/fullscale.g722 tool.b.out
+${TOOL_CMD} --sln16k --jobs 2 --outdir tool.outdir.out tool.a.out tool.b.out
+cmp tool.test.raw.16k.out tool.outdir.out/tool.a.out.raw
+cmp tool.fullscale.raw.out tool.outdir.out/tool.b.out.raw
+rm -rf tool.outdir.out
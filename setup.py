@@ -156,7 +156,7 @@ def main():
 
     mod_name = "G722"
     mod_name_dbg = mod_name + "_debug"
-    version = '1.2.8'
+    version = '1.3.0'
     repo_dir = realpath(dirname(__file__))
     package_variant = get_package_variant(repo_dir)
     src_dir = "."
@@ -230,6 +230,10 @@ def main():
             path_join(py_src_dir, mod_fname),
             path_join(src_dir, 'g722_decode.c'),
             path_join(src_dir, 'g722_encode.c'),
+            path_join(src_dir, 'g722_engine.c'),
+            path_join(src_dir, 'g722_qmf.c'),
+            path_join(src_dir, 'g722_resample.c'),
+            path_join(src_dir, 'g722_tables.c'),
         ],
         'include_dirs': [src_dir, py_src_dir],
         'extra_compile_args': compile_args,
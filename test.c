@@ -42,6 +42,9 @@
 
 #include "g722_encoder.h"
 #include "g722_decoder.h"
+#include "g722_multi.h"
+#include "g722_engine.h"
+#include "g722_rtp.h"
 
 /* Define byte order conversion functions for macOS */
 #if defined(__APPLE__)
@@ -58,19 +61,39 @@
 #endif
 
 #define BUFFER_SIZE 10
+#define MAX_CHANNELS 64
+/* Workers in the engine, more than the contexts so that they steal */
+#define ENGINE_THREADS 4
+
+#define LAW_NONE 0
+#define LAW_ULAW 1
+#define LAW_ALAW 2
+
+/* Odd numbers of codes to encode, or of bytes of packed codes to decode,
+   at a time, so that a packed stream is split other than on whole bytes,
+   or on whole codes */
+static const int odd_chunks[] = {7, 3, 5, 1};
+#define NCHUNKS (sizeof(odd_chunks) / sizeof(odd_chunks[0]))
 
 static void
 usage(const char *argv0)
 {
 
-    fprintf(stderr, "usage: %s [--sln16k] [--bend] file.g722 file.raw\n"
-      "       %s --encode [--sln16k] [--bend] file.raw file.g722\n", argv0,
-      argv0);
+    fprintf(stderr, "usage: %s [--sln16k] [--bend] [--multi N | --engine N] [--init] [--clone] file.g722 file.raw\n"
+      "       %s --encode [--sln16k] [--bend] [--multi N | --engine N] [--init] [--clone] file.raw file.g722\n"
+      "       %s [--encode] [--init] [--clone] --ulaw|--alaw infile outfile\n"
+      "       %s [--encode] [--sln16k] [--bend] [--init] [--clone] --rs48k infile outfile\n"
+      "       %s [--encode] [--sln16k] [--bend] [--init] [--clone] --rtp infile outfile\n"
+      "       %s [--encode] [--sln16k] [--bend] [--init] [--clone] [--rtp] --rate 56000|48000 --packed infile outfile\n"
+      "       and any of them can take --rate 64000|56000|48000\n",
+      argv0, argv0, argv0, argv0, argv0, argv0);
     exit (1);
 }
 
 static int
-parse_options(int argc, char **argv, int *srate, int *oblen, int *enc, int *bend)
+parse_options(int argc, char **argv, int *srate, int *oblen, int *enc, int *bend,
+  int *channels, int *engine, int *inplace, int *clone, int *law, int *rs48k,
+  int *rtp, int *rate, int *packed)
 {
     int argi;
 
@@ -78,6 +101,15 @@ parse_options(int argc, char **argv, int *srate, int *oblen, int *enc, int *bend
     *oblen = 1;
     *enc = 0;
     *bend = 0;
+    *channels = 0;
+    *engine = 0;
+    *inplace = 0;
+    *clone = 0;
+    *law = LAW_NONE;
+    *rs48k = 0;
+    *rtp = 0;
+    *rate = 64000;
+    *packed = 0;
 
     for (argi = 1; argi < argc; argi++) {
         if (strcmp(argv[argi], "--sln16k") == 0) {
@@ -87,16 +119,665 @@ parse_options(int argc, char **argv, int *srate, int *oblen, int *enc, int *bend
             *enc = 1;
         } else if (strcmp(argv[argi], "--bend") == 0) {
             *bend = 1;
+        } else if (strcmp(argv[argi], "--multi") == 0 && argi + 1 < argc) {
+            *channels = atoi(argv[++argi]);
+            if (*channels < 1 || *channels > MAX_CHANNELS)
+                usage(argv[0]);
+        } else if (strcmp(argv[argi], "--engine") == 0 && argi + 1 < argc) {
+            *engine = atoi(argv[++argi]);
+            if (*engine < 1 || *engine > MAX_CHANNELS)
+                usage(argv[0]);
+        } else if (strcmp(argv[argi], "--init") == 0) {
+            *inplace = 1;
+        } else if (strcmp(argv[argi], "--clone") == 0) {
+            *clone = 1;
+        } else if (strcmp(argv[argi], "--ulaw") == 0) {
+            *law = LAW_ULAW;
+        } else if (strcmp(argv[argi], "--alaw") == 0) {
+            *law = LAW_ALAW;
+        } else if (strcmp(argv[argi], "--rs48k") == 0) {
+            *rs48k = 1;
+        } else if (strcmp(argv[argi], "--rtp") == 0) {
+            *rtp = 1;
+        } else if (strcmp(argv[argi], "--rate") == 0 && argi + 1 < argc) {
+            *rate = atoi(argv[++argi]);
+            if (*rate != 64000 && *rate != 56000 && *rate != 48000)
+                usage(argv[0]);
+        } else if (strcmp(argv[argi], "--packed") == 0) {
+            *packed = 1;
         } else if (strncmp(argv[argi], "--", 2) == 0) {
             usage(argv[0]);
         } else {
             break;
         }
     }
+    /* G.711 is only ever 8k samples/second, one channel at a time */
+    if (*law != LAW_NONE && (*oblen != 1 || *channels > 0))
+        usage(argv[0]);
+    /* 48k audio is resampled from or to whichever rate the codec runs at */
+    if (*rs48k && (*law != LAW_NONE || *channels > 0))
+        usage(argv[0]);
+    /* The engine runs plain contexts, in place of the multi-channel codec */
+    if (*engine > 0 && (*channels > 0 || *law != LAW_NONE || *rs48k || *clone))
+        usage(argv[0]);
+    /* RTP carries the plain codec */
+    if (*rtp && (*channels > 0 || *engine > 0 || *law != LAW_NONE || *rs48k))
+        usage(argv[0]);
+    /* Packing is checked on the plain codec, and 8 bit codes have none */
+    if (*packed && (*channels > 0 || *engine > 0 || *law != LAW_NONE || *rs48k ||
+      *rate == 64000))
+        usage(argv[0]);
 
     return argi;
 }
 
+/*
+ * Run the same stream through every channel of the multi-channel codec,
+ * check that all channels agree, and hand back the first one.
+ */
+static void
+multi_check(int channels, int len, void *out[], size_t size)
+{
+    int ch;
+
+    for (ch = 1; ch < channels; ch++) {
+        if (memcmp(out[0], out[ch], size * len) != 0) {
+            fprintf(stderr, "channel %d differs from channel 0\n", ch);
+            exit (1);
+        }
+    }
+}
+
+static int
+multi_decode(G722_MDEC_CTX *ctx, int channels, const uint8_t *ibuf, int ib,
+  int16_t *obuf)
+{
+    static int16_t mbuf[MAX_CHANNELS][BUFFER_SIZE * 2];
+    const uint8_t *in[MAX_CHANNELS] = {NULL};
+    int16_t *out[MAX_CHANNELS] = {NULL};
+    int ch, len;
+
+    for (ch = 0; ch < channels; ch++) {
+        in[ch] = ibuf;
+        out[ch] = mbuf[ch];
+    }
+    len = g722_multi_decode(ctx, in, ib, out);
+    multi_check(channels, len, (void **)out, sizeof(obuf[0]));
+    memcpy(obuf, mbuf[0], len * sizeof(obuf[0]));
+    return len;
+}
+
+static int
+multi_encode(G722_MENC_CTX *ctx, int channels, const int16_t *ibuf, int len,
+  uint8_t *obuf)
+{
+    static uint8_t mbuf[MAX_CHANNELS][BUFFER_SIZE * 2];
+    const int16_t *in[MAX_CHANNELS] = {NULL};
+    uint8_t *out[MAX_CHANNELS] = {NULL};
+    int ch;
+
+    for (ch = 0; ch < channels; ch++) {
+        in[ch] = ibuf;
+        out[ch] = mbuf[ch];
+    }
+    len = g722_multi_encode(ctx, in, len, out);
+    multi_check(channels, len, (void **)out, sizeof(obuf[0]));
+    memcpy(obuf, mbuf[0], len);
+    return len;
+}
+
+/*
+ * Run the same stream through a context per channel on the batch engine,
+ * as two jobs per context so that they have to run in order, check that
+ * all channels agree, and hand back the first one.
+ */
+static int
+engine_decode(G722_ENGINE *e, G722_DEC_CTX *ctx[], int channels,
+  const uint8_t *ibuf, int ib, int oblen, int16_t *obuf)
+{
+    static int16_t mbuf[MAX_CHANNELS][BUFFER_SIZE * 2];
+    struct g722_job jobs[MAX_CHANNELS * 2];
+    void *out[MAX_CHANNELS];
+    int ch, half;
+
+    half = ib / 2;
+    for (ch = 0; ch < channels; ch++) {
+        jobs[2 * ch] = (struct g722_job){G722_JOB_DECODE, ctx[ch], ibuf, half,
+          mbuf[ch], 0};
+        jobs[2 * ch + 1] = (struct g722_job){G722_JOB_DECODE, ctx[ch],
+          ibuf + half, ib - half, mbuf[ch] + half * oblen, 0};
+        out[ch] = mbuf[ch];
+    }
+    if (g722_engine_run(e, jobs, channels * 2) != 0) {
+        fprintf(stderr, "g722_engine_run() failed\n");
+        exit (1);
+    }
+    for (ch = 0; ch < channels; ch++) {
+        if (jobs[2 * ch].result + jobs[2 * ch + 1].result != ib * oblen) {
+            fprintf(stderr, "engine job on channel %d came up short\n", ch);
+            exit (1);
+        }
+    }
+    multi_check(channels, ib * oblen, out, sizeof(obuf[0]));
+    memcpy(obuf, mbuf[0], ib * oblen * sizeof(obuf[0]));
+    return ib * oblen;
+}
+
+static int
+engine_encode(G722_ENGINE *e, G722_ENC_CTX *ctx[], int channels,
+  const int16_t *ibuf, int len, int oblen, uint8_t *obuf)
+{
+    static uint8_t mbuf[MAX_CHANNELS][BUFFER_SIZE * 2];
+    struct g722_job jobs[MAX_CHANNELS * 2];
+    void *out[MAX_CHANNELS];
+    int ch, half;
+
+    /* Split on a whole code */
+    half = (len / 2 / oblen) * oblen;
+    for (ch = 0; ch < channels; ch++) {
+        jobs[2 * ch] = (struct g722_job){G722_JOB_ENCODE, ctx[ch], ibuf, half,
+          mbuf[ch], 0};
+        jobs[2 * ch + 1] = (struct g722_job){G722_JOB_ENCODE, ctx[ch],
+          ibuf + half, len - half, mbuf[ch] + half / oblen, 0};
+        out[ch] = mbuf[ch];
+    }
+    if (g722_engine_run(e, jobs, channels * 2) != 0) {
+        fprintf(stderr, "g722_engine_run() failed\n");
+        exit (1);
+    }
+    for (ch = 0; ch < channels; ch++) {
+        if (jobs[2 * ch].result + jobs[2 * ch + 1].result != len / oblen) {
+            fprintf(stderr, "engine job on channel %d came up short\n", ch);
+            exit (1);
+        }
+    }
+    multi_check(channels, len / oblen, out, sizeof(obuf[0]));
+    memcpy(obuf, mbuf[0], len / oblen);
+    return len / oblen;
+}
+
+/*
+ * Pack codes of rb->bits each, least significant bit first, and unpack
+ * them as the decoder does, a code for as long as there is a byte left to
+ * start one with, the long way round as a reference for the packing folded
+ * into the codec.
+ */
+struct ref_bits {
+    int bits;
+    unsigned int acc;
+    int n;
+};
+
+static int
+ref_pack(struct ref_bits *rb, const uint8_t *codes, int ncodes, uint8_t *out)
+{
+    int i, len;
+
+    len = 0;
+    for (i = 0; i < ncodes; i++) {
+        rb->acc |= (unsigned int)codes[i] << rb->n;
+        rb->n += rb->bits;
+        while (rb->n >= 8) {
+            out[len++] = (uint8_t)rb->acc;
+            rb->acc >>= 8;
+            rb->n -= 8;
+        }
+    }
+    return len;
+}
+
+static int
+ref_unpack(struct ref_bits *rb, const uint8_t *in, int len, uint8_t *codes)
+{
+    int i, ncodes;
+
+    for (i = 0, ncodes = 0; i < len; ncodes++) {
+        if (rb->n < rb->bits) {
+            rb->acc |= (unsigned int)in[i++] << rb->n;
+            rb->n += 8;
+        }
+        codes[ncodes] = (uint8_t)(rb->acc & ((1u << rb->bits) - 1));
+        rb->acc >>= rb->bits;
+        rb->n -= rb->bits;
+    }
+    return ncodes;
+}
+
+/*
+ * Encode packed, and decode packed codes, and check that it comes to the
+ * same as the unpacked codes of a twin context, packed or unpacked by the
+ * reference.
+ */
+static int
+packed_encode(G722_ENC_CTX *ctx, G722_ENC_CTX *twin, struct ref_bits *rb,
+  const int16_t *ibuf, int len, uint8_t *obuf)
+{
+    uint8_t codes[BUFFER_SIZE * 2];
+    uint8_t rbuf[BUFFER_SIZE * 2];
+    int size;
+
+    size = g722_encode(ctx, ibuf, len, obuf);
+    len = g722_encode(twin, ibuf, len, codes);
+    if (size != ref_pack(rb, codes, len, rbuf) || memcmp(obuf, rbuf, size) != 0) {
+        fprintf(stderr, "packed encode differs from the unpacked one\n");
+        exit (1);
+    }
+    return size;
+}
+
+static int
+packed_decode(G722_DEC_CTX *ctx, G722_DEC_CTX *twin, struct ref_bits *rb,
+  const uint8_t *ibuf, int ib, int16_t *obuf)
+{
+    uint8_t codes[BUFFER_SIZE * 2];
+    int16_t tbuf[BUFFER_SIZE * 2];
+    int len;
+
+    len = g722_decode(ctx, ibuf, ib, obuf);
+    if (len != g722_decode(twin, codes, ref_unpack(rb, ibuf, ib, codes), tbuf) ||
+      memcmp(obuf, tbuf, len * sizeof(obuf[0])) != 0) {
+        fprintf(stderr, "packed decode differs from the unpacked one\n");
+        exit (1);
+    }
+    return len;
+}
+
+/*
+ * Wrap the codes in an RTP packet, with a header that varies from packet
+ * to packet, and decode them from there. The number of samples has to
+ * match the timestamp advance of the payload, or, packed, the codes the
+ * reference unpacks, which can run on from bits the last payload left.
+ */
+static int
+rtp_decode(G722_DEC_CTX *ctx, struct ref_bits *rb, const uint8_t *ibuf, int ib,
+  int oblen, int16_t *obuf)
+{
+    static unsigned int seq;
+    uint8_t pkt[12 + 15 * 4 + 4 + 8 + BUFFER_SIZE + 255];
+    uint8_t codes[BUFFER_SIZE * 2];
+    uint32_t ticks;
+    int cc, ext, pad, off, len;
+
+    cc = seq % 3;
+    ext = (seq / 3) % 2;
+    pad = (seq / 6) % 3 * 5;
+    seq++;
+    memset(pkt, 0xA5, sizeof(pkt));
+    pkt[0] = 0x80 | (pad ? 0x20 : 0) | (ext ? 0x10 : 0) | cc;
+    pkt[1] = 9;
+    off = 12 + 4 * cc;
+    if (ext) {
+        pkt[off + 2] = 0;
+        pkt[off + 3] = 2;
+        off += 4 + 8;
+    }
+    memcpy(pkt + off, ibuf, ib);
+    len = off + ib + pad;
+    if (pad)
+        pkt[len - 1] = pad;
+    len = g722_rtp_decode(ctx, pkt, len, obuf);
+    ticks = g722_rtp_decoder_ticks(ctx, ib);
+    if (rb != NULL && ticks != (uint32_t)(ib * 8 / rb->bits)) {
+        fprintf(stderr, "g722_rtp_decoder_ticks() returned %u\n", (unsigned int)ticks);
+        exit (1);
+    }
+    if (rb != NULL)
+        ticks = ref_unpack(rb, ibuf, ib, codes);
+    if (len < 0 || len != g722_rtp_decoder_samples(ctx, ticks)) {
+        fprintf(stderr, "g722_rtp_decode() returned %d\n", len);
+        exit (1);
+    }
+    /* A packet one tick late gives a wrapped, out of range, increment */
+    if (g722_rtp_decoder_samples(ctx, (uint32_t)-1) != -1 ||
+      g722_rtp_decoder_samples(ctx, 0x3FFFFFFF) != 0x3FFFFFFF * oblen) {
+        fprintf(stderr, "g722_rtp_decoder_samples() is out of range\n");
+        exit (1);
+    }
+    return len;
+}
+
+/*
+ * Encode into an RTP packet after a header, and into a list of buffers
+ * of awkward sizes, on a twin context, and check that both come to the
+ * same payload, and that the timestamp advances a tick per code.
+ */
+static int
+rtp_encode(G722_ENC_CTX *ctx, G722_ENC_CTX *twin, const int16_t *ibuf, int len,
+  int oblen, uint8_t *obuf)
+{
+    uint8_t pkt[12 + BUFFER_SIZE * 2];
+    uint8_t vbuf[BUFFER_SIZE * 2];
+    struct g722_iov iov[3];
+    int size, plen;
+
+    size = g722_rtp_payload_size(ctx, len);
+    if (g722_rtp_encode(ctx, ibuf, len, pkt, 12 + size - 1, 12) != -1) {
+        fprintf(stderr, "g722_rtp_encode() overran the packet\n");
+        exit (1);
+    }
+    plen = g722_rtp_encode(ctx, ibuf, len, pkt, sizeof(pkt), 12);
+    iov[0].iov_base = vbuf;
+    iov[0].iov_len = 1;
+    iov[1].iov_base = vbuf + 1;
+    iov[1].iov_len = 2;
+    iov[2].iov_base = vbuf + 3;
+    iov[2].iov_len = sizeof(vbuf) - 3;
+    if (plen != 12 + size || g722_rtp_encodev(twin, ibuf, len, iov, 3) != size ||
+      memcmp(pkt + 12, vbuf, size) != 0 ||
+      g722_rtp_encoder_ticks(ctx, len) != (uint32_t)(len / oblen)) {
+        fprintf(stderr, "RTP encode differs from the plain one\n");
+        exit (1);
+    }
+    memcpy(obuf, pkt + 12, size);
+    return size;
+}
+
+/*
+ * Carry on with a copy of the context, as a fan-out would, after checking
+ * that the copy is in the same state.
+ */
+static G722_DEC_CTX *
+clone_decoder(G722_DEC_CTX *ctx)
+{
+    G722_DEC_CTX *copy;
+
+    copy = g722_decoder_clone(ctx);
+    if (copy == NULL || !g722_decoder_state_equal(copy, ctx)) {
+        fprintf(stderr, "g722_decoder_clone() failed\n");
+        exit (1);
+    }
+    g722_decoder_destroy(ctx);
+    return copy;
+}
+
+static G722_ENC_CTX *
+clone_encoder(G722_ENC_CTX *ctx)
+{
+    G722_ENC_CTX *copy;
+
+    copy = g722_encoder_clone(ctx);
+    if (copy == NULL || !g722_encoder_state_equal(copy, ctx)) {
+        fprintf(stderr, "g722_encoder_clone() failed\n");
+        exit (1);
+    }
+    g722_encoder_destroy(ctx);
+    return copy;
+}
+
+/*
+ * The classic Sun G.711 conversions, done the long way round as a
+ * reference for the ones folded into the codec.
+ */
+static int
+ref_segment(int val, const int *ends)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        if (val <= ends[i])
+            return i;
+    }
+    return 8;
+}
+
+static uint8_t
+ref_linear_to_law(int law, int pcm_val)
+{
+    static const int ulaw_ends[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+    static const int alaw_ends[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+    int mask, seg;
+
+    if (law == LAW_ULAW) {
+        pcm_val >>= 2;
+        if (pcm_val < 0) {
+            pcm_val = -pcm_val;
+            mask = 0x7F;
+        } else {
+            mask = 0xFF;
+        }
+        if (pcm_val > 8159)
+            pcm_val = 8159;
+        pcm_val += 0x84 >> 2;
+        seg = ref_segment(pcm_val, ulaw_ends);
+        if (seg >= 8)
+            return 0x7F ^ mask;
+        return ((seg << 4) | ((pcm_val >> (seg + 1)) & 0xF)) ^ mask;
+    }
+    pcm_val >>= 3;
+    if (pcm_val >= 0) {
+        mask = 0xD5;
+    } else {
+        mask = 0x55;
+        pcm_val = -pcm_val - 1;
+    }
+    seg = ref_segment(pcm_val, alaw_ends);
+    if (seg >= 8)
+        return 0x7F ^ mask;
+    if (seg < 2)
+        return ((seg << 4) | ((pcm_val >> 1) & 0xF)) ^ mask;
+    return ((seg << 4) | ((pcm_val >> seg) & 0xF)) ^ mask;
+}
+
+static int
+ref_law_to_linear(int law, uint8_t val)
+{
+    int t, seg;
+
+    if (law == LAW_ULAW) {
+        val = ~val;
+        t = (((val & 0x0F) << 3) + 0x84) << ((val & 0x70) >> 4);
+        return (val & 0x80) ? (0x84 - t) : (t - 0x84);
+    }
+    val ^= 0x55;
+    t = (val & 0x0F) << 4;
+    seg = (val & 0x70) >> 4;
+    if (seg == 0)
+        t += 8;
+    else if (seg == 1)
+        t += 0x108;
+    else
+        t = (t + 0x108) << (seg - 1);
+    return (val & 0x80) ? t : -t;
+}
+
+/*
+ * Transcode straight between G.711 and G.722, and check that it comes to
+ * the same as going by way of linear audio on a twin context.
+ */
+static int
+law_decode(G722_DEC_CTX *ctx, G722_DEC_CTX *twin, int law, const uint8_t *ibuf,
+  int ib, uint8_t *obuf)
+{
+    int16_t lbuf[BUFFER_SIZE];
+    int i, len;
+
+    if (law == LAW_ULAW)
+        len = g722_decode_ulaw(ctx, ibuf, ib, obuf);
+    else
+        len = g722_decode_alaw(ctx, ibuf, ib, obuf);
+    if (len != g722_decode(twin, ibuf, ib, lbuf)) {
+        fprintf(stderr, "G.711 decode returned %d\n", len);
+        exit (1);
+    }
+    for (i = 0; i < len; i++) {
+        if (obuf[i] != ref_linear_to_law(law, lbuf[i])) {
+            fprintf(stderr, "G.711 decode differs from the linear one\n");
+            exit (1);
+        }
+    }
+    return len;
+}
+
+static int
+law_encode(G722_ENC_CTX *ctx, G722_ENC_CTX *twin, int law, const uint8_t *ibuf,
+  int ib, uint8_t *obuf)
+{
+    int16_t lbuf[BUFFER_SIZE];
+    uint8_t tbuf[BUFFER_SIZE];
+    int i, len;
+
+    for (i = 0; i < ib; i++)
+        lbuf[i] = ref_law_to_linear(law, ibuf[i]);
+    if (law == LAW_ULAW)
+        len = g722_encode_ulaw(ctx, ibuf, ib, obuf);
+    else
+        len = g722_encode_alaw(ctx, ibuf, ib, obuf);
+    if (len != g722_encode(twin, lbuf, ib, tbuf) || memcmp(obuf, tbuf, len) != 0) {
+        fprintf(stderr, "G.711 encode differs from the linear one\n");
+        exit (1);
+    }
+    return len;
+}
+
+/* The mean power of some audio */
+static double
+tone_power(const int16_t *amp, int len)
+{
+    double e;
+    int i;
+
+    e = 0.0;
+    for (i = 0; i < len; i++)
+        e += (double)amp[i] * amp[i];
+    return e / len;
+}
+
+/*
+ * Put a 1kHz tone, in the band the codec carries, and a 12kHz one, above
+ * it, through 48k encoders and decoders, and check that the first comes
+ * out at the level it went in at, and that the decimator all but removes
+ * the second. Contexts not set up for 48k have to refuse it.
+ */
+static void
+check_rs48k_tones(int srate)
+{
+    /* A second at 48k, the first 100ms of it left for the filters to settle */
+    static int16_t amp[48000], out[48000];
+    static uint8_t codes[48000 / 6];
+    /* A 1kHz step of phase at 48k samples/second */
+    const double c = 0.99144486137381041, s = 0.13052619222005157;
+    const int settle = 4800;
+    G722_ENC_CTX *ectx;
+    G722_DEC_CTX *dctx;
+    double x, y, t, gain;
+    int i, tone, len;
+
+    for (tone = 0; tone < 2; tone++) {
+        x = 1.0;
+        y = 0.0;
+        for (i = 0; i < 48000; i++) {
+            if (tone == 0) {
+                amp[i] = (int16_t)(10000.0 * y);
+                t = x * c - y * s;
+                y = x * s + y * c;
+                x = t;
+            } else {
+                amp[i] = (i & 1) ? ((i & 2) ? -16000 : 16000) : 0;
+            }
+        }
+        ectx = g722_encoder_new(64000, srate | G722_RESAMPLE_48000);
+        dctx = g722_decoder_new(64000, srate | G722_RESAMPLE_48000);
+        if (ectx == NULL || dctx == NULL) {
+            fprintf(stderr, "g722_encoder_new() or g722_decoder_new() failed\n");
+            exit (1);
+        }
+        len = g722_encode_48khz(ectx, amp, 48000, codes);
+        if (g722_decode_48khz(dctx, codes, len, out) != 48000) {
+            fprintf(stderr, "g722_decode_48khz() returned a short block\n");
+            exit (1);
+        }
+        /* Whole cycles of both tones */
+        gain = tone_power(out + settle, 48000 - settle) / tone_power(amp + settle, 48000 - settle);
+        if ((tone == 0 && (gain < 0.89 || gain > 1.12)) || (tone == 1 && gain > 1e-4)) {
+            fprintf(stderr, "%s tone through 48k comes out at %g of its power\n",
+              (tone == 0) ? "1kHz" : "12kHz", gain);
+            exit (1);
+        }
+        g722_encoder_destroy(ectx);
+        g722_decoder_destroy(dctx);
+    }
+    ectx = g722_encoder_new(64000, srate);
+    dctx = g722_decoder_new(64000, srate);
+    if (ectx == NULL || dctx == NULL || g722_encode_48khz(ectx, amp, 6, codes) != -1 ||
+      g722_decode_48khz(dctx, codes, 1, out) != -1) {
+        fprintf(stderr, "48k on a context not set up for it\n");
+        exit (1);
+    }
+    g722_encoder_destroy(ectx);
+    g722_decoder_destroy(dctx);
+}
+
+static void
+write_samples(FILE *fo, int16_t *buf, int len, int bend)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        if (bend == 0) {
+            buf[i] = htole16(buf[i]);
+        } else {
+            buf[i] = htobe16(buf[i]);
+        }
+    }
+    fwrite(buf, len * sizeof(buf[0]), 1, fo);
+    fflush(fo);
+}
+
+/*
+ * Check that the counters a context kept add up, given the samples each
+ * code comes to, or 0 if that varies. A library built without them must
+ * say so, and give nothing but zeroes.
+ */
+static void
+check_stats(const char *what, int kept, const struct g722_stats *st,
+  int samples_per_code)
+{
+    static const struct g722_stats zero;
+    uint64_t hist, nb[2];
+    int i;
+
+    if (!kept) {
+        if (memcmp(st, &zero, sizeof(zero)) != 0) {
+            fprintf(stderr, "%s stats not kept, but not zeroed\n", what);
+            exit (1);
+        }
+        return;
+    }
+    hist = nb[0] = nb[1] = 0;
+    for (i = 0; i < 256; i++)
+        hist += st->code_hist[i];
+    for (i = 0; i < 12; i++) {
+        nb[0] += st->nb_hist[0][i];
+        nb[1] += st->nb_hist[1][i];
+    }
+    if (hist != st->codes || nb[0] != st->codes ||
+      (nb[1] != st->codes && nb[1] != 0) ||
+      st->silent_codes > st->codes || st->idle_codes > st->codes ||
+      st->full_scale > st->samples || (st->codes > 0 && st->calls == 0) ||
+      (samples_per_code > 0 && st->samples != st->codes * samples_per_code)) {
+        fprintf(stderr, "%s stats do not add up\n", what);
+        exit (1);
+    }
+}
+
+static void
+check_encoder_stats(const G722_ENC_CTX *ctx, int samples_per_code)
+{
+    struct g722_stats st;
+
+    check_stats("encoder", g722_encoder_get_stats(ctx, &st) == 0, &st,
+      samples_per_code);
+}
+
+static void
+check_decoder_stats(const G722_DEC_CTX *ctx, int samples_per_code)
+{
+    struct g722_stats st;
+
+    check_stats("decoder", g722_decoder_get_stats(ctx, &st) == 0, &st,
+      samples_per_code);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -105,11 +786,35 @@ main(int argc, char **argv)
     int16_t obuf[BUFFER_SIZE * 2];
     G722_DEC_CTX *g722_dctx;
     G722_ENC_CTX *g722_ectx;
-    int i, srate, enc, bend;
+    G722_MDEC_CTX *g722_mdctx = NULL;
+    G722_MENC_CTX *g722_mectx = NULL;
+    G722_ENGINE *engine_ctx = NULL;
+    G722_DEC_CTX *engine_dctx[MAX_CHANNELS];
+    G722_ENC_CTX *engine_ectx[MAX_CHANNELS];
+    G722_DEC_CTX *law_dctx = NULL;
+    G722_ENC_CTX *law_ectx = NULL;
+    G722_ENC_CTX *rtp_ectx = NULL;
+    G722_DEC_CTX *packed_dctx = NULL;
+    G722_ENC_CTX *packed_ectx = NULL;
+    struct ref_bits ref;
+    uint8_t lbuf[BUFFER_SIZE];
+    int16_t wbuf[BUFFER_SIZE * 6];
+    int i, srate, enc, bend, channels, engine, inplace, clone, law, rs48k, rtp;
+    int rate, packed, options, len;
+    unsigned int nchunk = 0;
+    void *mem = NULL;
     int oblen;
     int first_arg;
 
-    first_arg = parse_options(argc, argv, &srate, &oblen, &enc, &bend);
+    first_arg = parse_options(argc, argv, &srate, &oblen, &enc, &bend,
+      &channels, &engine, &inplace, &clone, &law, &rs48k, &rtp, &rate, &packed);
+    /* The contexts under test pack, their unpacked twins do not, and only
+       they have room for 48k */
+    options = srate | (packed ? G722_PACKED : 0) | (rs48k ? G722_RESAMPLE_48000 : 0);
+    if (rs48k)
+        check_rs48k_tones(srate);
+    memset(&ref, 0, sizeof(ref));
+    ref.bits = (rate == 56000) ? 7 : 6;
 
     if (argc - first_arg != 2) {
         usage(argv[0]);
@@ -128,31 +833,178 @@ main(int argc, char **argv)
 
     int ib;
     if (enc == 0) {
-        g722_dctx = g722_decoder_new(64000, srate);
+        if (inplace) {
+            mem = malloc(g722_decoder_state_size() + 1);
+            if (mem != NULL && g722_decoder_init((char *)mem + 1, rate, options) != NULL) {
+                fprintf(stderr, "g722_decoder_init() took misaligned memory\n");
+                exit (1);
+            }
+            g722_dctx = g722_decoder_init(mem, rate, options);
+        } else {
+            g722_dctx = g722_decoder_new(rate, options);
+        }
         if (g722_dctx == NULL) {
             fprintf(stderr, "g722_decoder_new() failed\n");
             exit (1);
         }
-        while ((ib=fread(ibuf, 1, sizeof(ibuf), fi)) >= 1) {
-            g722_decode(g722_dctx, ibuf, ib, obuf);
-            for (i = 0; i < (ib * oblen); i++) {
+        if (channels > 0) {
+            g722_mdctx = g722_multi_decoder_new(channels, rate, srate);
+            if (g722_mdctx == NULL) {
+                fprintf(stderr, "g722_multi_decoder_new() failed\n");
+                exit (1);
+            }
+        }
+        if (engine > 0) {
+            engine_ctx = g722_engine_new(ENGINE_THREADS, G722_ENGINE_NO_PIN);
+            if (engine_ctx == NULL) {
+                fprintf(stderr, "g722_engine_new() failed\n");
+                exit (1);
+            }
+            for (i = 0; i < engine; i++) {
+                engine_dctx[i] = g722_decoder_new(rate, srate);
+                if (engine_dctx[i] == NULL) {
+                    fprintf(stderr, "g722_decoder_new() failed\n");
+                    exit (1);
+                }
+            }
+        }
+        if (law != LAW_NONE) {
+            law_dctx = g722_decoder_new(rate, srate);
+            if (law_dctx == NULL) {
+                fprintf(stderr, "g722_decoder_new() failed\n");
+                exit (1);
+            }
+        }
+        if (packed && !rtp) {
+            packed_dctx = g722_decoder_new(rate, srate);
+            if (packed_dctx == NULL) {
+                fprintf(stderr, "g722_decoder_new() failed\n");
+                exit (1);
+            }
+        }
+        while ((ib=fread(ibuf, 1, packed ? odd_chunks[nchunk++ % NCHUNKS] : (int)sizeof(ibuf), fi)) >= 1) {
+            if (law_dctx != NULL) {
+                ib = law_decode(g722_dctx, law_dctx, law, ibuf, ib, lbuf);
+                if (clone)
+                    g722_dctx = clone_decoder(g722_dctx);
+                fwrite(lbuf, ib, 1, fo);
+                fflush(fo);
+                continue;
+            }
+            if (rs48k) {
+                if (g722_decode_48khz(g722_dctx, ibuf, ib, wbuf) != ib * 6) {
+                    fprintf(stderr, "g722_decode_48khz() returned a short block\n");
+                    exit (1);
+                }
+                if (clone)
+                    g722_dctx = clone_decoder(g722_dctx);
+                write_samples(fo, wbuf, ib * 6, bend);
+                continue;
+            }
+            if (g722_mdctx != NULL)
+                len = multi_decode(g722_mdctx, channels, ibuf, ib, obuf);
+            else if (engine_ctx != NULL)
+                len = engine_decode(engine_ctx, engine_dctx, engine, ibuf, ib, oblen, obuf);
+            else if (rtp)
+                len = rtp_decode(g722_dctx, packed ? &ref : NULL, ibuf, ib, oblen, obuf);
+            else if (packed_dctx != NULL)
+                len = packed_decode(g722_dctx, packed_dctx, &ref, ibuf, ib, obuf);
+            else
+                len = g722_decode(g722_dctx, ibuf, ib, obuf);
+            if (clone)
+                g722_dctx = clone_decoder(g722_dctx);
+            for (i = 0; i < len; i++) {
                 if (bend == 0) {
                     obuf[i] = htole16(obuf[i]);
                 } else {
                     obuf[i] = htobe16(obuf[i]);
                 }
             }
-            fwrite(obuf, ib * oblen * sizeof(obuf[0]), 1, fo);
+            fwrite(obuf, len * sizeof(obuf[0]), 1, fo);
             fflush(fo);
         }
+        check_decoder_stats(g722_dctx, rs48k ? 6 : oblen);
     } else {
-        g722_ectx = g722_encoder_new(64000, srate);
+        if (inplace) {
+            mem = malloc(g722_encoder_state_size() + 1);
+            if (mem != NULL && g722_encoder_init((char *)mem + 1, rate, options) != NULL) {
+                fprintf(stderr, "g722_encoder_init() took misaligned memory\n");
+                exit (1);
+            }
+            g722_ectx = g722_encoder_init(mem, rate, options);
+        } else {
+            g722_ectx = g722_encoder_new(rate, options);
+        }
         if (g722_ectx == NULL) {
             fprintf(stderr, "g722_encoder_new() failed\n");
             exit (1);
         }
+        if (channels > 0) {
+            g722_mectx = g722_multi_encoder_new(channels, rate, srate);
+            if (g722_mectx == NULL) {
+                fprintf(stderr, "g722_multi_encoder_new() failed\n");
+                exit (1);
+            }
+        }
+        if (engine > 0) {
+            engine_ctx = g722_engine_new(ENGINE_THREADS, G722_ENGINE_NO_PIN);
+            if (engine_ctx == NULL) {
+                fprintf(stderr, "g722_engine_new() failed\n");
+                exit (1);
+            }
+            for (i = 0; i < engine; i++) {
+                engine_ectx[i] = g722_encoder_new(rate, srate);
+                if (engine_ectx[i] == NULL) {
+                    fprintf(stderr, "g722_encoder_new() failed\n");
+                    exit (1);
+                }
+            }
+        }
+        if (rtp) {
+            rtp_ectx = g722_encoder_new(rate, options);
+            if (rtp_ectx == NULL) {
+                fprintf(stderr, "g722_encoder_new() failed\n");
+                exit (1);
+            }
+        }
+        if (law != LAW_NONE) {
+            law_ectx = g722_encoder_new(rate, srate);
+            if (law_ectx == NULL) {
+                fprintf(stderr, "g722_encoder_new() failed\n");
+                exit (1);
+            }
+        }
+        if (packed && !rtp) {
+            packed_ectx = g722_encoder_new(rate, srate);
+            if (packed_ectx == NULL) {
+                fprintf(stderr, "g722_encoder_new() failed\n");
+                exit (1);
+            }
+        }
+        while (law_ectx != NULL && (ib=fread(lbuf, 1, sizeof(lbuf), fi)) >= 1) {
+            ib = law_encode(g722_ectx, law_ectx, law, lbuf, ib, ibuf);
+            if (clone)
+                g722_ectx = clone_encoder(g722_ectx);
+            fwrite(ibuf, ib, 1, fo);
+            fflush(fo);
+        }
+        while (rs48k && (ib=fread(wbuf, 1, sizeof(wbuf), fi)) >= 1) {
+            int ibnelem = ib / sizeof(wbuf[0]);
+            for (i = 0; i < ibnelem; i++) {
+                if (bend == 0) {
+                    wbuf[i] = le16toh(wbuf[i]);
+                } else {
+                    wbuf[i] = be16toh(wbuf[i]);
+                }
+            }
+            ib = g722_encode_48khz(g722_ectx, wbuf, ibnelem, ibuf);
+            if (clone)
+                g722_ectx = clone_encoder(g722_ectx);
+            fwrite(ibuf, ib, 1, fo);
+            fflush(fo);
+        }
         int insize = sizeof(obuf) / ((oblen == 1) ? 2 : 1);
-        while ((ib=fread(obuf, 1, insize, fi)) >= 1) {
+        while ((ib=fread(obuf, 1, packed ? odd_chunks[nchunk++ % NCHUNKS] * oblen * (int)sizeof(obuf[0]) : insize, fi)) >= 1) {
             int ibnelem = ib / sizeof(obuf[0]);
             for (i = 0; i < ibnelem; i++) {
                 if (bend == 0) {
@@ -161,12 +1013,27 @@ main(int argc, char **argv)
                     obuf[i] = be16toh(obuf[i]);
                 }
             }
-            g722_encode(g722_ectx, obuf, ibnelem, ibuf);
-            fwrite(ibuf, ibnelem / oblen, 1, fo);
+            if (g722_mectx != NULL)
+                len = multi_encode(g722_mectx, channels, obuf, ibnelem, ibuf);
+            else if (engine_ctx != NULL)
+                len = engine_encode(engine_ctx, engine_ectx, engine, obuf, ibnelem, oblen, ibuf);
+            else if (rtp_ectx != NULL)
+                len = rtp_encode(g722_ectx, rtp_ectx, obuf, ibnelem, oblen, ibuf);
+            else if (packed_ectx != NULL)
+                len = packed_encode(g722_ectx, packed_ectx, &ref, obuf, ibnelem, ibuf);
+            else
+                len = g722_encode(g722_ectx, obuf, ibnelem, ibuf);
+            if (clone)
+                g722_ectx = clone_encoder(g722_ectx);
+            fwrite(ibuf, len, 1, fo);
             fflush(fo);
         }
+        check_encoder_stats(g722_ectx, rs48k ? 0 : oblen);
     }
 
+    if (engine_ctx != NULL)
+        g722_engine_destroy(engine_ctx);
+
     fclose(fi);
     fclose(fo);
 
@@ -0,0 +1,57 @@
+import os
+import unittest
+import numpy as np
+
+import G722 as G722_mod
+from G722 import G722
+
+class TestBatch(unittest.TestCase):
+    DATA_DIR = os.path.join(os.path.dirname(__file__), '../test_data')
+    PCM_FILE = os.path.join(DATA_DIR, 'pcminb.dat')
+
+    def setUp(self):
+        with open(self.PCM_FILE, 'rb') as f:
+            pcm = np.frombuffer(f.read(), dtype='>i2').astype(np.int16)
+        # Channels that differ, and an odd length
+        self.rows = np.stack([np.roll(pcm, 331 * k)[:16001] for k in range(6)])
+
+    def test_encode_batch(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                expected = [G722(sr, 56000).encode(r) for r in self.rows]
+                out = G722_mod.encode_batch(self.rows, sr, 56000, threads=3)
+                self.assertEqual(out.shape, (len(self.rows), len(expected[0])))
+                self.assertEqual(out.dtype, np.uint8)
+                self.assertEqual(expected, [r.tobytes() for r in out])
+
+                out = G722_mod.encode_batch(self.rows.astype('>i2'), sr, 56000, threads=1)
+                self.assertEqual(expected, [r.tobytes() for r in out])
+
+                out = G722_mod.encode_batch(list(self.rows), sr, 56000, use_numpy=False)
+                self.assertEqual(expected, out)
+
+    def test_decode_batch(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                encoded = G722_mod.encode_batch(self.rows, sr, 64000)
+                expected = np.stack([np.asarray(G722(sr, 64000).decode(r.tobytes()))
+                  for r in encoded])
+                out = G722_mod.decode_batch(encoded, sr, 64000)
+                self.assertEqual(out.dtype, np.int16)
+                self.assertTrue(np.array_equal(expected, out))
+
+                out = G722_mod.decode_batch([r.tobytes() for r in encoded], sr, 64000,
+                  threads=2, use_numpy=False)
+                self.assertTrue(np.array_equal(expected, np.array(out)))
+
+    def test_bad_batch(self):
+        with self.assertRaises(ValueError):
+            G722_mod.decode_batch([b'\x00' * 4, b'\x00' * 5], 16000, 64000)
+        with self.assertRaises(ValueError):
+            G722_mod.encode_batch(self.rows, 44100, 64000)
+        with self.assertRaises(TypeError):
+            G722_mod.encode_batch(5, 16000, 64000)
+        self.assertEqual(G722_mod.encode_batch(self.rows[:0], 16000, 64000).shape, (0, 8000))
+
+if __name__ == '__main__':
+    unittest.main()
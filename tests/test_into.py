@@ -0,0 +1,64 @@
+import os
+import unittest
+import numpy as np
+
+from G722 import G722
+
+class TestInto(unittest.TestCase):
+    DATA_DIR = os.path.join(os.path.dirname(__file__), '../test_data')
+    PCM_FILE = os.path.join(DATA_DIR, 'pcminb.dat')
+
+    def setUp(self):
+        with open(self.PCM_FILE, 'rb') as f:
+            self.pcm = np.frombuffer(f.read(), dtype='<i2')
+
+    def test_encode_into(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                fsize = sr // 50
+                expected = G722(sr, 64000).encode(self.pcm)
+                codec = G722(sr, 64000)
+                out = bytearray(fsize)
+                encoded = b''
+                for j in range(0, len(self.pcm) - fsize + 1, fsize):
+                    n = codec.encode_into(self.pcm[j:j + fsize], out)
+                    encoded += out[:n]
+                self.assertEqual(expected[:len(encoded)], encoded)
+
+                arr = np.zeros(len(expected), dtype=np.uint8)
+                n = G722(sr, 64000).encode_into(self.pcm, memoryview(arr))
+                self.assertEqual(n, len(expected))
+                self.assertEqual(expected, arr.tobytes())
+
+    def test_decode_into(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                encoded = G722(sr, 64000).encode(self.pcm)
+                expected = np.asarray(G722(sr, 64000).decode(encoded), dtype='<i2')
+
+                out = np.zeros(len(expected), dtype=np.int16)
+                n = G722(sr, 64000).decode_into(encoded, out)
+                self.assertEqual(n, len(expected))
+                self.assertTrue(np.array_equal(expected, out))
+
+                out = np.zeros(len(expected), dtype='>i2')
+                G722(sr, 64000).decode_into(bytearray(encoded), out)
+                self.assertTrue(np.array_equal(expected, out))
+
+                out = bytearray(2 * len(expected))
+                G722(sr, 64000).decode_into(memoryview(encoded), out)
+                self.assertEqual(expected.astype(np.int16).tobytes(), bytes(out))
+
+    def test_too_small(self):
+        codec = G722(16000, 64000)
+        with self.assertRaises(ValueError):
+            codec.encode_into(self.pcm[:320], bytearray(159))
+        with self.assertRaises(ValueError):
+            codec.decode_into(b'\x00' * 160, np.zeros(319, dtype=np.int16))
+        with self.assertRaises(BufferError):
+            codec.decode_into(b'\x00' * 160, b'\x00' * 640)
+        with self.assertRaises(TypeError):
+            codec.decode_into(b'\x00' * 160, np.zeros(320, dtype=np.int32))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,59 @@
+import os
+import unittest
+import numpy as np
+
+from G722 import G722
+
+class TestPackets(unittest.TestCase):
+    DATA_DIR = os.path.join(os.path.dirname(__file__), '../test_data')
+    PCM_FILE = os.path.join(DATA_DIR, 'pcminb.dat')
+
+    def setUp(self):
+        with open(self.PCM_FILE, 'rb') as f:
+            self.pcm = np.frombuffer(f.read(), dtype='>i2').astype(np.int16)
+
+    def test_encode_frames(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                flen = sr // 50
+                expected = G722(sr, 64000).encode(self.pcm)
+                payloads, offsets = G722(sr, 64000).encode_frames(self.pcm, flen)
+                self.assertEqual(expected, payloads)
+                fbytes = flen if sr == 8000 else flen // 2
+                self.assertEqual(list(offsets[:3]), [0, fbytes, 2 * fbytes])
+                self.assertEqual(offsets[-1], len(payloads))
+                # The last frame is what is left over
+                self.assertEqual(len(offsets) - 1, -(-len(payloads) // fbytes))
+
+    def test_decode_packets(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                encoded = G722(sr, 64000).encode(self.pcm)
+                expected = np.asarray(G722(sr, 64000).decode(encoded))
+                packets = [encoded[i:i + 160] for i in range(0, len(encoded), 160)]
+                # Any buffer will do, bytes are just the fastest
+                packets[1] = bytearray(packets[1])
+                packets[2] = memoryview(packets[2])
+                samples, offsets = G722(sr, 64000).decode_packets(packets)
+                self.assertTrue(np.array_equal(expected, np.asarray(samples)))
+                k = 1 if sr == 8000 else 2
+                self.assertEqual(len(offsets), len(packets) + 1)
+                for i, p in enumerate(packets):
+                    self.assertEqual(offsets[i + 1] - offsets[i], k * len(p))
+
+    def test_bad_args(self):
+        codec = G722(16000, 64000)
+        samples, offsets = codec.decode_packets([])
+        self.assertEqual(len(samples), 0)
+        self.assertEqual(list(offsets), [0])
+        with self.assertRaises(TypeError):
+            codec.decode_packets([b'\x00' * 4, 5])
+        with self.assertRaises(TypeError):
+            codec.decode_packets()
+        with self.assertRaises(ValueError):
+            codec.encode_frames(self.pcm, 161)
+        with self.assertRaises(TypeError):
+            codec.encode(self.pcm, 1)
+
+if __name__ == '__main__':
+    unittest.main()
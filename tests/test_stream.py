@@ -0,0 +1,112 @@
+import gc
+import io
+import os
+import unittest
+import weakref
+import numpy as np
+
+from G722 import G722
+
+class Trickle(io.RawIOBase):
+    # Reads and writes a few bytes at a time, as pipes and sockets may
+    def __init__(self, data=b'', step=7):
+        self.data = memoryview(data)
+        self.pos = 0
+        self.step = step
+        self.out = bytearray()
+
+    def readable(self):
+        return True
+
+    def writable(self):
+        return True
+
+    def readinto(self, b):
+        n = min(len(b), self.step, len(self.data) - self.pos)
+        b[:n] = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return n
+
+    def write(self, b):
+        n = min(len(b), self.step)
+        self.out += bytes(b[:n])
+        return n
+
+class TestStream(unittest.TestCase):
+    DATA_DIR = os.path.join(os.path.dirname(__file__), '../test_data')
+    PCM_FILE = os.path.join(DATA_DIR, 'pcminb.dat')
+
+    def setUp(self):
+        with open(self.PCM_FILE, 'rb') as f:
+            self.pcm_be = f.read()
+        self.pcm = np.frombuffer(self.pcm_be, dtype='>i2').astype(np.int16)
+
+    def test_encode_stream(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                expected = G722(sr, 64000).encode(self.pcm)
+                out = io.BytesIO()
+                n = G722(sr, 64000).encode_stream(io.BytesIO(self.pcm_be), out,
+                  chunk=1002, byteorder='big')
+                self.assertEqual(n, len(expected))
+                self.assertEqual(expected, out.getvalue())
+
+                src = Trickle(self.pcm.astype('<i2').tobytes())
+                dst = Trickle()
+                G722(sr, 64000).encode_stream(src, dst, chunk=64)
+                self.assertEqual(expected, bytes(dst.out))
+
+    def test_decode_stream(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                encoded = G722(sr, 64000).encode(self.pcm)
+                expected = np.asarray(G722(sr, 64000).decode(encoded), dtype=np.int16)
+                for order in ('little', 'big'):
+                    out = io.BytesIO()
+                    n = G722(sr, 64000).decode_stream(io.BytesIO(encoded), out,
+                      chunk=333, byteorder=order)
+                    self.assertEqual(n, len(expected))
+                    dtype = '<i2' if order == 'little' else '>i2'
+                    self.assertEqual(expected.astype(dtype).tobytes(), out.getvalue())
+
+                dst = Trickle()
+                G722(sr, 64000).decode_stream(Trickle(encoded, step=5), dst)
+                self.assertEqual(expected.astype('<i2').tobytes(), bytes(dst.out))
+
+    def test_iter(self):
+        for sr in (8000, 16000):
+            with self.subTest(sample_rate=sr):
+                expected = G722(sr, 64000).encode(self.pcm)
+                chunks = list(G722(sr, 64000).iter_encode(io.BytesIO(self.pcm_be),
+                  chunk=4000, byteorder='big'))
+                self.assertTrue(all(len(c) <= 2000 for c in chunks))
+                self.assertEqual(expected, b''.join(chunks))
+
+                decoded = np.asarray(G722(sr, 64000).decode(expected), dtype=np.int16)
+                chunks = list(G722(sr, 64000).iter_decode(io.BytesIO(expected), chunk=500))
+                self.assertEqual(len(chunks), (len(expected) + 499) // 500)
+                self.assertTrue(np.array_equal(decoded,
+                  np.concatenate([np.asarray(c, dtype=np.int16) for c in chunks])))
+
+    def test_iter_cycle(self):
+        # A source that keeps its own iterator is still collected
+        src = Trickle(self.pcm_be)
+        src.it = G722(16000, 64000).iter_encode(src)
+        next(src.it)
+        ref = weakref.ref(src)
+        del src
+        gc.collect()
+        self.assertIsNone(ref())
+
+    def test_bad_args(self):
+        codec = G722(16000, 64000)
+        with self.assertRaises(ValueError):
+            codec.encode_stream(io.BytesIO(), io.BytesIO(), chunk=2)
+        with self.assertRaises(ValueError):
+            codec.decode_stream(io.BytesIO(), io.BytesIO(), byteorder='middle')
+        with self.assertRaises(AttributeError):
+            next(codec.iter_decode(b'\x00' * 16))
+        self.assertEqual(list(codec.iter_encode(io.BytesIO(b'\x00' * 3))), [])
+
+if __name__ == '__main__':
+    unittest.main()
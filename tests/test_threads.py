@@ -0,0 +1,58 @@
+import os
+import unittest
+import threading
+import numpy as np
+
+from G722 import G722
+
+class TestThreads(unittest.TestCase):
+    DATA_DIR = os.path.join(os.path.dirname(__file__), '../test_data')
+    PCM_FILE = os.path.join(DATA_DIR, 'pcminb.dat')
+    NTHREADS = 4
+
+    def setUp(self):
+        with open(self.PCM_FILE, 'rb') as f:
+            self.pcm = np.frombuffer(f.read(), dtype='<i2')
+
+    def run_threads(self, target):
+        threads = [threading.Thread(target=target, args=(i,))
+                   for i in range(self.NTHREADS)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+    def test_one_codec_per_thread(self):
+        # Each thread has its own state, so every one must match a serial run
+        expected = G722(16000, 64000).encode(self.pcm)
+        encoded = [None] * self.NTHREADS
+        decoded = [None] * self.NTHREADS
+
+        def work(i):
+            codec = G722(16000, 64000)
+            encoded[i] = b''.join(codec.encode(self.pcm[j:j + 320])
+                                  for j in range(0, len(self.pcm), 320))
+            decoded[i] = np.asarray(G722(16000, 64000).decode(encoded[i]), dtype='<i2')
+
+        self.run_threads(work)
+        expected_dec = np.asarray(G722(16000, 64000).decode(expected), dtype='<i2')
+        for i in range(self.NTHREADS):
+            self.assertEqual(expected, encoded[i])
+            self.assertTrue(np.array_equal(expected_dec, decoded[i]))
+
+    def test_shared_codec(self):
+        # Calls on one object interleave in no particular order, but each
+        # one runs whole, so the output sizes are all there is to check
+        codec = G722(8000, 64000)
+        sizes = [0] * self.NTHREADS
+
+        def work(i):
+            for j in range(0, len(self.pcm), 160):
+                frame = codec.encode(self.pcm[j:j + 160])
+                sizes[i] += len(codec.decode(frame))
+
+        self.run_threads(work)
+        self.assertEqual(sizes, [len(self.pcm)] * self.NTHREADS)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Batch G.722 encoder and decoder for whole files. Inputs are mapped where
+ * the platform allows it and run through the codec straight from the
+ * mapping, a large block at a time, and each block of output goes out in
+ * one write. Several files are done at once, one per worker thread.
+ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g722_encoder.h"
+#include "g722_decoder.h"
+#include "g722_engine.h"
+
+#include "g722_pool.h"
+
+#if defined(_WIN32)
+#define open _open
+#define read _read
+#define write _write
+#define close _close
+#define O_FLAGS (_O_BINARY)
+#else
+#define O_FLAGS 0
+#endif
+
+/* Samples per encode call, and bytes per decode call */
+#define ENC_BLOCK (256 * 1024)
+#define DEC_BLOCK (128 * 1024)
+/* Samples out of one byte at most: 8 / 6 codes at 48k packed, 2 samples each */
+#define DEC_OUT_MAX (DEC_BLOCK * 8 / 6 * 2 + 4)
+
+struct opts {
+    int enc;
+    int rate;
+    int options;
+    int bend;
+    const char *out;
+    const char *outdir;
+};
+
+struct file_job {
+    const char *in;
+    char *out;
+    int failed;
+};
+
+struct batch {
+    const struct opts *o;
+    struct file_job *jobs;
+    int njobs;
+};
+
+/* Where the bytes of an input file come from */
+struct source {
+    int fd;
+    const uint8_t *map;
+    size_t map_len;
+    size_t pos;
+    /* For when the input cannot be mapped */
+    uint8_t *buf;
+};
+
+static int host_be;
+
+static void
+usage(void)
+{
+
+    fprintf(stderr, "usage: g722 [--encode] [--sln16k] [--bend] [--rate 64000|56000|48000]\n"
+      "       [--packed] [--jobs N] [-o outfile | --outdir DIR] file ...\n");
+    exit (1);
+}
+
+static void
+swap16(int16_t *buf, const int16_t *src, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = (int16_t)(((uint16_t)src[i] >> 8) | ((uint16_t)src[i] << 8));
+}
+
+static int
+write_all(int fd, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+    long n;
+
+    while (len > 0) {
+        n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int
+source_open(struct source *src, const char *path)
+{
+#if !defined(_WIN32)
+    struct stat st;
+#endif
+
+    memset(src, 0, sizeof(*src));
+    if (strcmp(path, "-") == 0) {
+        src->fd = 0;
+    } else if ((src->fd = open(path, O_RDONLY | O_FLAGS)) < 0) {
+        return -1;
+    }
+#if !defined(_WIN32)
+    if (fstat(src->fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        src->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, src->fd, 0);
+        if (src->map != MAP_FAILED) {
+            src->map_len = st.st_size;
+#if defined(MADV_SEQUENTIAL)
+            madvise((void *)src->map, src->map_len, MADV_SEQUENTIAL);
+#endif
+            return 0;
+        }
+        src->map = NULL;
+    }
+#endif
+    if ((src->buf = malloc(ENC_BLOCK * sizeof(int16_t))) == NULL)
+        return -1;
+    return 0;
+}
+
+/*
+ * The next block of up to len bytes, straight from the mapping, or read
+ * in full unless the input ends first. Returns the number of bytes, 0 at
+ * the end, or -1 on error.
+ */
+static long
+source_next(struct source *src, const uint8_t **data, size_t len)
+{
+    size_t got;
+    long n;
+
+    if (src->map != NULL) {
+        if (len > src->map_len - src->pos)
+            len = src->map_len - src->pos;
+        *data = src->map + src->pos;
+        src->pos += len;
+        return (long)len;
+    }
+    for (got = 0; got < len; got += n) {
+        n = read(src->fd, src->buf + got, len - got);
+        if (n < 0) {
+            if (errno == EINTR) {
+                n = 0;
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0)
+            break;
+    }
+    *data = src->buf;
+    return (long)got;
+}
+
+static void
+source_close(struct source *src)
+{
+
+#if !defined(_WIN32)
+    if (src->map != NULL)
+        munmap((void *)src->map, src->map_len);
+#endif
+    free(src->buf);
+    if (src->fd > 0)
+        close(src->fd);
+}
+
+static int
+encode_file(const struct opts *o, struct source *src, int fd)
+{
+    G722_ENC_CTX *ctx;
+    const uint8_t *data;
+    int16_t *pcm;
+    uint8_t *codes;
+    long n;
+    int ncodes, rc;
+
+    ctx = g722_encoder_new(o->rate, o->options);
+    pcm = malloc(ENC_BLOCK * sizeof(pcm[0]));
+    codes = malloc(ENC_BLOCK);
+    rc = -1;
+    if (ctx == NULL || pcm == NULL || codes == NULL)
+        goto out;
+    while ((n = source_next(src, &data, ENC_BLOCK * sizeof(pcm[0]))) > 0) {
+        n /= sizeof(pcm[0]);
+        /* The mapping is page aligned and blocks are whole samples, so
+           audio in host order can be encoded where it lies */
+        if (o->bend == host_be) {
+            ncodes = g722_encode(ctx, (const int16_t *)data, n, codes);
+        } else {
+            swap16(pcm, (const int16_t *)data, n);
+            ncodes = g722_encode(ctx, pcm, n, codes);
+        }
+        if (write_all(fd, codes, ncodes) < 0)
+            goto out;
+    }
+    if (n == 0)
+        rc = 0;
+out:
+    if (ctx != NULL)
+        g722_encoder_destroy(ctx);
+    free(pcm);
+    free(codes);
+    return rc;
+}
+
+static int
+decode_file(const struct opts *o, struct source *src, int fd)
+{
+    G722_DEC_CTX *ctx;
+    const uint8_t *data;
+    int16_t *pcm;
+    long n;
+    int len, rc;
+
+    ctx = g722_decoder_new(o->rate, o->options);
+    pcm = malloc(DEC_OUT_MAX * sizeof(pcm[0]));
+    rc = -1;
+    if (ctx == NULL || pcm == NULL)
+        goto out;
+    while ((n = source_next(src, &data, DEC_BLOCK)) > 0) {
+        len = g722_decode(ctx, data, n, pcm);
+        if (o->bend != host_be)
+            swap16(pcm, pcm, len);
+        if (write_all(fd, pcm, len * sizeof(pcm[0])) < 0)
+            goto out;
+    }
+    if (n == 0)
+        rc = 0;
+out:
+    if (ctx != NULL)
+        g722_decoder_destroy(ctx);
+    free(pcm);
+    return rc;
+}
+
+static int
+transcode(const struct opts *o, struct file_job *job)
+{
+    struct source src;
+    int fd, rc;
+
+    if (source_open(&src, job->in) < 0) {
+        fprintf(stderr, "g722: %s: %s\n", job->in, strerror(errno));
+        return -1;
+    }
+    if (strcmp(job->out, "-") == 0) {
+        fd = 1;
+#if defined(_WIN32)
+        _setmode(fd, _O_BINARY);
+#endif
+    } else if ((fd = open(job->out, O_WRONLY | O_CREAT | O_TRUNC | O_FLAGS, 0644)) < 0) {
+        fprintf(stderr, "g722: %s: %s\n", job->out, strerror(errno));
+        source_close(&src);
+        return -1;
+    }
+    rc = (o->enc) ? encode_file(o, &src, fd) : decode_file(o, &src, fd);
+    if (rc < 0)
+        fprintf(stderr, "g722: %s: %s\n", job->in, strerror(errno));
+    if (fd != 1 && close(fd) < 0 && rc == 0) {
+        fprintf(stderr, "g722: %s: %s\n", job->out, strerror(errno));
+        rc = -1;
+    }
+    source_close(&src);
+    return rc;
+}
+
+static void
+transcode_job(void *arg, int i)
+{
+    struct batch *b = arg;
+
+    b->jobs[i].failed = (transcode(b->o, &b->jobs[i]) < 0);
+}
+
+/* The output for an input: given outright, or the input with a suffix, in
+   the output directory if there is one */
+static char *
+out_name(const struct opts *o, const char *in)
+{
+    const char *base, *suffix;
+    char *name;
+    size_t len;
+
+    if (o->out != NULL)
+        return strdup(o->out);
+    suffix = (o->enc) ? ".g722" : ".raw";
+    base = in;
+    if (o->outdir != NULL) {
+        base = strrchr(in, '/');
+#if defined(_WIN32)
+        if (strrchr(in, '\\') > base)
+            base = strrchr(in, '\\');
+#endif
+        base = (base != NULL) ? base + 1 : in;
+    }
+    len = ((o->outdir != NULL) ? strlen(o->outdir) + 1 : 0) + strlen(base) + strlen(suffix) + 1;
+    if ((name = malloc(len)) == NULL)
+        return NULL;
+    if (o->outdir != NULL)
+        snprintf(name, len, "%s/%s%s", o->outdir, base, suffix);
+    else
+        snprintf(name, len, "%s%s", base, suffix);
+    return name;
+}
+
+int
+main(int argc, char **argv)
+{
+    const uint16_t one = 1;
+    struct opts o;
+    struct batch b;
+    int argi, i, nthreads, failed;
+
+    host_be = (*(const uint8_t *)&one == 0);
+    memset(&o, 0, sizeof(o));
+    o.rate = 64000;
+    o.options = G722_SAMPLE_RATE_8000;
+    nthreads = g722_engine_cpus();
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--encode") == 0 || strcmp(argv[argi], "--enc") == 0) {
+            o.enc = 1;
+        } else if (strcmp(argv[argi], "--sln16k") == 0) {
+            o.options &= ~G722_SAMPLE_RATE_8000;
+        } else if (strcmp(argv[argi], "--bend") == 0) {
+            o.bend = 1;
+        } else if (strcmp(argv[argi], "--packed") == 0) {
+            o.options |= G722_PACKED;
+        } else if (strcmp(argv[argi], "--rate") == 0 && argi + 1 < argc) {
+            o.rate = atoi(argv[++argi]);
+            if (o.rate != 64000 && o.rate != 56000 && o.rate != 48000)
+                usage();
+        } else if (strcmp(argv[argi], "--jobs") == 0 && argi + 1 < argc) {
+            nthreads = atoi(argv[++argi]);
+            if (nthreads < 1)
+                usage();
+        } else if (strcmp(argv[argi], "-o") == 0 && argi + 1 < argc) {
+            o.out = argv[++argi];
+        } else if (strcmp(argv[argi], "--outdir") == 0 && argi + 1 < argc) {
+            o.outdir = argv[++argi];
+        } else if (strncmp(argv[argi], "--", 2) == 0 || (argv[argi][0] == '-' && argv[argi][1] != '\0')) {
+            usage();
+        } else {
+            break;
+        }
+    }
+    /* One output name is for one input */
+    if (argi == argc || (o.out != NULL && (argc - argi != 1 || o.outdir != NULL)))
+        usage();
+
+    memset(&b, 0, sizeof(b));
+    b.o = &o;
+    b.njobs = argc - argi;
+    if ((b.jobs = calloc(b.njobs, sizeof(b.jobs[0]))) == NULL) {
+        fprintf(stderr, "g722: out of memory\n");
+        exit (1);
+    }
+    for (i = 0; i < b.njobs; i++) {
+        b.jobs[i].in = argv[argi + i];
+        if ((b.jobs[i].out = out_name(&o, b.jobs[i].in)) == NULL) {
+            fprintf(stderr, "g722: out of memory\n");
+            exit (1);
+        }
+    }
+
+    pool_run(transcode_job, &b, b.njobs, nthreads);
+
+    failed = 0;
+    for (i = 0; i < b.njobs; i++) {
+        failed |= b.jobs[i].failed;
+        free(b.jobs[i].out);
+    }
+    free(b.jobs);
+    return (failed) ? 1 : 0;
+}
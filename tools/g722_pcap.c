@@ -0,0 +1,806 @@
+/*
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Decoder for the G.722 RTP streams in pcap and pcapng captures. Every
+ * capture is mapped and scanned for RTP over UDP, over IPv4 or IPv6, on
+ * Ethernet (with VLAN tags), Linux cooked, loopback or raw IP links. The
+ * packets are sorted into streams by SSRC and then into sequence number
+ * order, and the streams are decoded, each to its own WAV or raw file,
+ * one per worker thread. The payloads are decoded where they lie in the
+ * mapping, and a timestamp gap left by lost packets is filled with silence.
+ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g722_decoder.h"
+#include "g722_engine.h"
+#include "g722_rtp.h"
+
+#include "g722_pool.h"
+
+/* The static payload type of G.722, RFC 3551 */
+#define RTP_PT_G722 9
+/* Longest timestamp gap filled with silence, 10 seconds of RTP clock */
+#define MAX_GAP_TICKS (8000 * 10)
+
+#define LINKTYPE_NULL 0
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_LOOP 108
+#define LINKTYPE_LINUX_SLL 113
+#define LINKTYPE_IPV4 228
+#define LINKTYPE_IPV6 229
+#define LINKTYPE_LINUX_SLL2 276
+/* DLT_RAW as some systems write it */
+#define DLT_RAW_BSD 12
+#define DLT_RAW_OPENBSD 14
+
+struct opts {
+    int pt;
+    int options;
+    int raw;
+    int verbose;
+    const char *outdir;
+};
+
+struct packet {
+    const uint8_t *payload;
+    int len;
+    uint32_t ts;
+    /* The sequence number, extended past wraps */
+    int64_t seq;
+    uint32_t arrival;
+};
+
+struct stream {
+    uint32_t ssrc;
+    const struct capture *cap;
+    struct packet *pkt;
+    int npkt;
+    int size;
+    int64_t max_seq;
+    struct stream *hnext;
+    int failed;
+};
+
+#define STREAM_BUCKETS 1024
+
+struct capture {
+    const char *path;
+    /* The file name part of the path, which the output names start with */
+    const char *base;
+    const uint8_t *data;
+    size_t len;
+    int mapped;
+    struct stream **streams;
+    int nstreams;
+    struct stream *bucket[STREAM_BUCKETS];
+    uint32_t arrival;
+    int failed;
+};
+
+struct tool {
+    const struct opts *o;
+    struct capture *caps;
+    int ncaps;
+    struct stream **streams;
+    int nstreams;
+};
+
+static void
+usage(void)
+{
+
+    fprintf(stderr, "usage: g722_pcap [--pt N] [--sln8k] [--raw] [--jobs N] [--outdir DIR]\n"
+      "       [--verbose] capture ...\n");
+    exit (1);
+}
+
+static uint16_t
+be16(const uint8_t *p)
+{
+
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t
+be32(const uint8_t *p)
+{
+
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/* A capture field, in the byte order the capture was written in */
+static uint32_t
+rd32(const uint8_t *p, int big)
+{
+
+    if (big)
+        return be32(p);
+    return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+static uint16_t
+rd16(const uint8_t *p, int big)
+{
+
+    return (big) ? be16(p) : (uint16_t)((p[1] << 8) | p[0]);
+}
+
+static int
+map_capture(struct capture *cap)
+{
+#if defined(_WIN32)
+    FILE *f;
+    long size;
+
+    if ((f = fopen(cap->path, "rb")) == NULL)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    cap->data = malloc(size > 0 ? size : 1);
+    if (cap->data == NULL || fread((void *)cap->data, 1, size, f) != (size_t)size) {
+        fclose(f);
+        return -1;
+    }
+    cap->len = size;
+    fclose(f);
+    return 0;
+#else
+    struct stat st;
+    int fd;
+
+    if ((fd = open(cap->path, O_RDONLY)) < 0)
+        return -1;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    cap->len = st.st_size;
+    if (cap->len == 0) {
+        close(fd);
+        cap->data = (const uint8_t *)"";
+        return 0;
+    }
+    cap->data = mmap(NULL, cap->len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (cap->data == MAP_FAILED)
+        return -1;
+    cap->mapped = 1;
+#if defined(MADV_SEQUENTIAL)
+    madvise((void *)cap->data, cap->len, MADV_SEQUENTIAL);
+#endif
+    return 0;
+#endif
+}
+
+static void
+unmap_capture(struct capture *cap)
+{
+
+#if defined(_WIN32)
+    free((void *)cap->data);
+#else
+    if (cap->mapped)
+        munmap((void *)cap->data, cap->len);
+#endif
+}
+
+static struct stream *
+find_stream(struct capture *cap, uint32_t ssrc)
+{
+    struct stream **link, *st, **streams;
+
+    link = &cap->bucket[(ssrc * 2654435761u) >> 22];
+    for (st = *link; st != NULL; st = st->hnext) {
+        if (st->ssrc == ssrc)
+            return st;
+    }
+    if ((st = calloc(1, sizeof(*st))) == NULL)
+        return NULL;
+    if ((cap->nstreams & (cap->nstreams - 1)) == 0) {
+        streams = realloc(cap->streams, (cap->nstreams ? 2 * cap->nstreams : 1) * sizeof(streams[0]));
+        if (streams == NULL) {
+            free(st);
+            return NULL;
+        }
+        cap->streams = streams;
+    }
+    st->ssrc = ssrc;
+    st->cap = cap;
+    st->hnext = *link;
+    *link = st;
+    cap->streams[cap->nstreams++] = st;
+    return st;
+}
+
+static int
+add_rtp(struct capture *cap, const struct opts *o, const uint8_t *rtp, int len)
+{
+    const uint8_t *payload;
+    struct packet *pkt;
+    struct stream *st;
+    int64_t seq;
+    int plen;
+
+    if (len < 12 || (rtp[0] >> 6) != 2 || (rtp[1] & 0x7F) != o->pt)
+        return 0;
+    if ((plen = g722_rtp_payload(rtp, len, &payload)) <= 0)
+        return 0;
+    if ((st = find_stream(cap, be32(rtp + 8))) == NULL)
+        return -1;
+    if (st->npkt == st->size) {
+        st->size = (st->size) ? 2 * st->size : 256;
+        if ((pkt = realloc(st->pkt, st->size * sizeof(pkt[0]))) == NULL)
+            return -1;
+        st->pkt = pkt;
+    }
+    /* Extend the sequence number from the highest one so far */
+    if (st->npkt == 0)
+        seq = be16(rtp + 2);
+    else
+        seq = st->max_seq + (int16_t)(be16(rtp + 2) - (uint16_t)st->max_seq);
+    if (st->npkt == 0 || seq > st->max_seq)
+        st->max_seq = seq;
+    pkt = &st->pkt[st->npkt++];
+    pkt->payload = payload;
+    pkt->len = plen;
+    pkt->ts = be32(rtp + 4);
+    pkt->seq = seq;
+    pkt->arrival = cap->arrival++;
+    return 0;
+}
+
+/* Find the UDP payload of an IP packet */
+static const uint8_t *
+ip_udp(const uint8_t *ip, size_t len, int *ulen)
+{
+    size_t off, n;
+    int nh;
+
+    if (len < 1)
+        return NULL;
+    if ((ip[0] >> 4) == 4) {
+        off = (ip[0] & 0x0F) * 4;
+        if (len < 20 || off < 20 || off > len)
+            return NULL;
+        if (be16(ip + 2) < len)
+            len = be16(ip + 2);
+        /* Fragments cannot be put back together here */
+        if ((be16(ip + 6) & 0x3FFF) != 0 || ip[9] != 17)
+            return NULL;
+    } else if ((ip[0] >> 4) == 6) {
+        if (len < 40)
+            return NULL;
+        if (40 + (size_t)be16(ip + 4) < len)
+            len = 40 + be16(ip + 4);
+        nh = ip[6];
+        off = 40;
+        /* Hop by hop, routing and destination options, and AH */
+        while (nh == 0 || nh == 43 || nh == 60 || nh == 51) {
+            if (off + 2 > len)
+                return NULL;
+            n = (nh == 51) ? (ip[off + 1] + 2) * 4 : (ip[off + 1] + 1) * 8;
+            nh = ip[off];
+            off += n;
+        }
+        if (nh != 17)
+            return NULL;
+    } else {
+        return NULL;
+    }
+    if (off + 8 > len)
+        return NULL;
+    n = be16(ip + off + 4);
+    /* Skip datagrams cut short by the snap length */
+    if (n < 8 || off + n > len)
+        return NULL;
+    *ulen = (int)(n - 8);
+    return ip + off + 8;
+}
+
+/* Find the IP packet in a link layer frame */
+static const uint8_t *
+link_ip(int linktype, const uint8_t *p, size_t len, size_t *iplen)
+{
+    size_t off;
+    int et;
+
+    switch (linktype) {
+    case LINKTYPE_ETHERNET:
+        if (len < 14)
+            return NULL;
+        et = be16(p + 12);
+        off = 14;
+        /* 802.1Q and 802.1ad tags */
+        while (et == 0x8100 || et == 0x88A8 || et == 0x9100) {
+            if (off + 4 > len)
+                return NULL;
+            et = be16(p + off + 2);
+            off += 4;
+        }
+        if (et != 0x0800 && et != 0x86DD)
+            return NULL;
+        break;
+    case LINKTYPE_LINUX_SLL:
+        if (len < 16)
+            return NULL;
+        et = be16(p + 14);
+        off = 16;
+        if (et != 0x0800 && et != 0x86DD)
+            return NULL;
+        break;
+    case LINKTYPE_LINUX_SLL2:
+        if (len < 20)
+            return NULL;
+        et = be16(p);
+        off = 20;
+        if (et != 0x0800 && et != 0x86DD)
+            return NULL;
+        break;
+    case LINKTYPE_NULL:
+    case LINKTYPE_LOOP:
+        /* The address family, which the IP version says well enough */
+        off = 4;
+        break;
+    case LINKTYPE_RAW:
+    case LINKTYPE_IPV4:
+    case LINKTYPE_IPV6:
+    case DLT_RAW_BSD:
+    case DLT_RAW_OPENBSD:
+        off = 0;
+        break;
+    default:
+        return NULL;
+    }
+    if (off > len)
+        return NULL;
+    *iplen = len - off;
+    return p + off;
+}
+
+static int
+add_frame(struct capture *cap, const struct opts *o, int linktype, const uint8_t *p, size_t len)
+{
+    const uint8_t *ip, *udp;
+    size_t iplen;
+    int ulen;
+
+    if ((ip = link_ip(linktype, p, len, &iplen)) == NULL)
+        return 0;
+    if ((udp = ip_udp(ip, iplen, &ulen)) == NULL)
+        return 0;
+    return add_rtp(cap, o, udp, ulen);
+}
+
+static int
+parse_pcap(struct capture *cap, const struct opts *o)
+{
+    const uint8_t *p = cap->data;
+    size_t off, caplen;
+    uint32_t magic;
+    int big, linktype;
+
+    magic = rd32(p, 0);
+    /* Microsecond or nanosecond timestamps, in either byte order */
+    big = (magic == 0xD4C3B2A1 || magic == 0x4D3CB2A1);
+    if (cap->len < 24)
+        return -1;
+    linktype = rd32(p + 20, big) & 0xFFFF;
+    for (off = 24; off + 16 <= cap->len; off += 16 + caplen) {
+        caplen = rd32(p + off + 8, big);
+        if (caplen > cap->len - off - 16)
+            break;
+        if (add_frame(cap, o, linktype, p + off + 16, caplen) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+#define PCAPNG_SHB 0x0A0D0D0A
+#define PCAPNG_IDB 1
+#define PCAPNG_OPB 2
+#define PCAPNG_SPB 3
+#define PCAPNG_EPB 6
+#define PCAPNG_MAX_IF 256
+
+static int
+parse_pcapng(struct capture *cap, const struct opts *o)
+{
+    const uint8_t *p = cap->data, *b;
+    int linktype[PCAPNG_MAX_IF];
+    uint32_t type, blen, ifid, caplen;
+    size_t off;
+    int big, nif;
+
+    big = 0;
+    nif = 0;
+    for (off = 0; off + 12 <= cap->len; off += blen) {
+        b = p + off;
+        type = rd32(b, big);
+        if (type == PCAPNG_SHB) {
+            /* Every section sets its own byte order and interfaces */
+            big = (rd32(b + 8, 0) != 0x1A2B3C4D);
+            nif = 0;
+        }
+        blen = rd32(b + 4, big);
+        if (blen < 12 || (blen & 3) != 0 || blen > cap->len - off)
+            break;
+        switch (type) {
+        case PCAPNG_IDB:
+            if (blen >= 20 && nif < PCAPNG_MAX_IF)
+                linktype[nif++] = rd16(b + 8, big);
+            break;
+        case PCAPNG_EPB:
+        case PCAPNG_OPB:
+            if (blen < 32)
+                break;
+            ifid = (type == PCAPNG_EPB) ? rd32(b + 8, big) : rd16(b + 8, big);
+            caplen = rd32(b + 20, big);
+            if (ifid >= (uint32_t)nif || caplen > blen - 32)
+                break;
+            if (add_frame(cap, o, linktype[ifid], b + 28, caplen) < 0)
+                return -1;
+            break;
+        case PCAPNG_SPB:
+            if (blen < 16 || nif == 0)
+                break;
+            caplen = rd32(b + 8, big);
+            if (caplen > blen - 16)
+                caplen = blen - 16;
+            if (add_frame(cap, o, linktype[0], b + 12, caplen) < 0)
+                return -1;
+            break;
+        }
+    }
+    return 0;
+}
+
+static void
+parse_capture(void *arg, int i)
+{
+    struct tool *t = arg;
+    struct capture *cap = &t->caps[i];
+    uint32_t magic;
+    int rc;
+
+    if (map_capture(cap) < 0) {
+        fprintf(stderr, "g722_pcap: %s: %s\n", cap->path, strerror(errno));
+        cap->failed = 1;
+        return;
+    }
+    magic = (cap->len >= 4) ? rd32(cap->data, 0) : 0;
+    if (magic == PCAPNG_SHB) {
+        rc = parse_pcapng(cap, t->o);
+    } else if (magic == 0xA1B2C3D4 || magic == 0xD4C3B2A1 || magic == 0xA1B23C4D || magic == 0x4D3CB2A1) {
+        rc = parse_pcap(cap, t->o);
+    } else {
+        fprintf(stderr, "g722_pcap: %s: not a pcap or pcapng file\n", cap->path);
+        cap->failed = 1;
+        return;
+    }
+    if (rc < 0) {
+        fprintf(stderr, "g722_pcap: %s: out of memory\n", cap->path);
+        cap->failed = 1;
+    }
+}
+
+static int
+packet_cmp(const void *a, const void *b)
+{
+    const struct packet *pa = a, *pb = b;
+
+    if (pa->seq != pb->seq)
+        return (pa->seq < pb->seq) ? -1 : 1;
+    return (pa->arrival < pb->arrival) ? -1 : (pa->arrival > pb->arrival);
+}
+
+static void
+put_le32(uint8_t *p, uint32_t v)
+{
+
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static int
+write_stream(const struct opts *o, const struct stream *st, const int16_t *pcm, size_t len)
+{
+    uint8_t hdr[44];
+    const uint16_t one = 1;
+    const char *sep;
+    char path[4096];
+    int16_t *le;
+    uint32_t rate, bytes;
+    size_t i;
+    FILE *f;
+    int rc;
+
+    sep = (o->outdir != NULL) ? "/" : "";
+    snprintf(path, sizeof(path), "%s%s%s.%08x.%s", (o->outdir != NULL) ? o->outdir : "", sep,
+      st->cap->base, (unsigned int)st->ssrc, (o->raw) ? "raw" : "wav");
+    if ((f = fopen(path, "wb")) == NULL) {
+        fprintf(stderr, "g722_pcap: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    le = NULL;
+    if (*(const uint8_t *)&one == 0) {
+        /* WAV and our raw files are little endian */
+        if ((le = malloc(len * sizeof(le[0]))) == NULL) {
+            fclose(f);
+            return -1;
+        }
+        for (i = 0; i < len; i++)
+            le[i] = (int16_t)(((uint16_t)pcm[i] >> 8) | ((uint16_t)pcm[i] << 8));
+        pcm = le;
+    }
+    rc = 0;
+    if (!o->raw) {
+        rate = (o->options & G722_SAMPLE_RATE_8000) ? 8000 : 16000;
+        bytes = (len > 0x7FFFFFF0 / 2) ? 0x7FFFFFF0 : (uint32_t)(len * 2);
+        memcpy(hdr, "RIFF\0\0\0\0WAVEfmt ", 16);
+        put_le32(hdr + 4, 36 + bytes);
+        put_le32(hdr + 16, 16);
+        /* PCM, one channel */
+        put_le32(hdr + 20, 1 | (1 << 16));
+        put_le32(hdr + 24, rate);
+        put_le32(hdr + 28, rate * 2);
+        /* 2 bytes a frame, 16 bits a sample */
+        put_le32(hdr + 32, 2 | (16 << 16));
+        memcpy(hdr + 36, "data", 4);
+        put_le32(hdr + 40, bytes);
+        if (fwrite(hdr, sizeof(hdr), 1, f) != 1)
+            rc = -1;
+    }
+    if (rc == 0 && len > 0 && fwrite(pcm, len * sizeof(pcm[0]), 1, f) != 1)
+        rc = -1;
+    if (fclose(f) != 0)
+        rc = -1;
+    if (rc < 0)
+        fprintf(stderr, "g722_pcap: %s: %s\n", path, strerror(errno));
+    free(le);
+    return rc;
+}
+
+
+/* The samples lost between a packet and the one before it, going by the
+   timestamps, or none if the gap is too long to be believed */
+static size_t
+gap_samples(const G722_DEC_CTX *ctx, const struct packet *prev, const struct packet *pkt)
+{
+    int32_t gap;
+
+    gap = (int32_t)(pkt->ts - prev->ts - g722_rtp_decoder_ticks(ctx, prev->len));
+    if (gap <= 0 || gap > MAX_GAP_TICKS)
+        return 0;
+    return g722_rtp_decoder_samples(ctx, gap);
+}
+
+static void
+decode_stream(void *arg, int i)
+{
+    struct tool *t = arg;
+    const struct opts *o = t->o;
+    struct stream *st = t->streams[i];
+    struct g722_iov *run;
+    struct packet *pkt;
+    G722_DEC_CTX *ctx;
+    int16_t *pcm;
+    size_t len, pos, fill;
+    int64_t lost;
+    int n, k, nrun, dups;
+
+    qsort(st->pkt, st->npkt, sizeof(st->pkt[0]), packet_cmp);
+    /* Drop the copies of packets that arrived more than once */
+    for (n = 0, k = 0; k < st->npkt; k++) {
+        if (n > 0 && st->pkt[k].seq == st->pkt[n - 1].seq)
+            continue;
+        st->pkt[n++] = st->pkt[k];
+    }
+    dups = st->npkt - n;
+    st->npkt = n;
+
+    pcm = NULL;
+    ctx = g722_decoder_new(64000, o->options);
+    run = malloc(st->npkt * sizeof(run[0]));
+    if (ctx == NULL || run == NULL)
+        goto nomem;
+    len = 0;
+    for (k = 0; k < st->npkt; k++) {
+        if (k > 0)
+            len += gap_samples(ctx, &st->pkt[k - 1], &st->pkt[k]);
+        len += g722_rtp_decoder_samples(ctx, g722_rtp_decoder_ticks(ctx, st->pkt[k].len));
+    }
+    /* Zeroed, so the gaps are silence already */
+    if ((pcm = calloc(len ? len : 1, sizeof(pcm[0]))) == NULL)
+        goto nomem;
+    /* Decode each unbroken run of payloads in one go */
+    pos = 0;
+    nrun = 0;
+    lost = 0;
+    for (k = 0; k < st->npkt; k++) {
+        pkt = &st->pkt[k];
+        if (k > 0) {
+            lost += pkt->seq - pkt[-1].seq - 1;
+            if ((fill = gap_samples(ctx, &pkt[-1], pkt)) > 0) {
+                pos += g722_rtp_decodev(ctx, run, nrun, pcm + pos) + fill;
+                nrun = 0;
+            }
+        }
+        run[nrun].iov_base = (void *)pkt->payload;
+        run[nrun].iov_len = pkt->len;
+        nrun++;
+    }
+    pos += g722_rtp_decodev(ctx, run, nrun, pcm + pos);
+    if (o->verbose) {
+        fprintf(stderr, "%s: ssrc %08x: %d packets, %lld lost, %d duplicate, %zu samples\n",
+          st->cap->path, (unsigned int)st->ssrc, st->npkt, (long long)lost, dups, pos);
+    }
+    st->failed = (write_stream(o, st, pcm, pos) < 0);
+    goto out;
+nomem:
+    fprintf(stderr, "g722_pcap: out of memory\n");
+    st->failed = 1;
+out:
+    if (ctx != NULL)
+        g722_decoder_destroy(ctx);
+    free(run);
+    free(pcm);
+}
+
+/* By the name of the output, so that streams that would share one are
+   next to each other */
+static int
+stream_name_cmp(const void *a, const void *b)
+{
+    const struct stream *sa = *(struct stream *const *)a, *sb = *(struct stream *const *)b;
+    int r;
+
+    if ((r = strcmp(sa->cap->base, sb->cap->base)) != 0)
+        return r;
+    return (sa->ssrc > sb->ssrc) - (sa->ssrc < sb->ssrc);
+}
+
+/* Longest first, so that no long stream is started last */
+static int
+stream_cmp(const void *a, const void *b)
+{
+    const struct stream *sa = *(struct stream *const *)a, *sb = *(struct stream *const *)b;
+
+    return (sa->npkt < sb->npkt) - (sa->npkt > sb->npkt);
+}
+
+int
+main(int argc, char **argv)
+{
+    struct opts o;
+    struct tool t;
+    int argi, i, j, nthreads, failed;
+
+    memset(&o, 0, sizeof(o));
+    o.pt = RTP_PT_G722;
+    nthreads = g722_engine_cpus();
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--sln8k") == 0) {
+            o.options |= G722_SAMPLE_RATE_8000;
+        } else if (strcmp(argv[argi], "--raw") == 0) {
+            o.raw = 1;
+        } else if (strcmp(argv[argi], "--verbose") == 0 || strcmp(argv[argi], "-v") == 0) {
+            o.verbose = 1;
+        } else if (strcmp(argv[argi], "--pt") == 0 && argi + 1 < argc) {
+            o.pt = atoi(argv[++argi]);
+            if (o.pt < 0 || o.pt > 127)
+                usage();
+        } else if (strcmp(argv[argi], "--jobs") == 0 && argi + 1 < argc) {
+            nthreads = atoi(argv[++argi]);
+            if (nthreads < 1)
+                usage();
+        } else if (strcmp(argv[argi], "--outdir") == 0 && argi + 1 < argc) {
+            o.outdir = argv[++argi];
+        } else if (strncmp(argv[argi], "--", 2) == 0 || (argv[argi][0] == '-' && argv[argi][1] != '\0')) {
+            usage();
+        } else {
+            break;
+        }
+    }
+    if (argi == argc)
+        usage();
+
+    memset(&t, 0, sizeof(t));
+    t.o = &o;
+    t.ncaps = argc - argi;
+    if ((t.caps = calloc(t.ncaps, sizeof(t.caps[0]))) == NULL) {
+        fprintf(stderr, "g722_pcap: out of memory\n");
+        exit (1);
+    }
+    for (i = 0; i < t.ncaps; i++) {
+        t.caps[i].path = argv[argi + i];
+        t.caps[i].base = strrchr(t.caps[i].path, '/');
+#if defined(_WIN32)
+        if (strrchr(t.caps[i].path, '\\') > t.caps[i].base)
+            t.caps[i].base = strrchr(t.caps[i].path, '\\');
+#endif
+        t.caps[i].base = (t.caps[i].base != NULL) ? t.caps[i].base + 1 : t.caps[i].path;
+    }
+    pool_run(parse_capture, &t, t.ncaps, nthreads);
+
+    /* Then every stream of every capture at once */
+    for (i = 0; i < t.ncaps; i++)
+        t.nstreams += t.caps[i].nstreams;
+    if ((t.streams = malloc((t.nstreams ? t.nstreams : 1) * sizeof(t.streams[0]))) == NULL) {
+        fprintf(stderr, "g722_pcap: out of memory\n");
+        exit (1);
+    }
+    t.nstreams = 0;
+    for (i = 0; i < t.ncaps; i++) {
+        for (j = 0; j < t.caps[i].nstreams; j++)
+            t.streams[t.nstreams++] = t.caps[i].streams[j];
+    }
+    /* Rather than have one stream overwrite another */
+    qsort(t.streams, t.nstreams, sizeof(t.streams[0]), stream_name_cmp);
+    for (i = 1; i < t.nstreams; i++) {
+        if (stream_name_cmp(&t.streams[i - 1], &t.streams[i]) == 0) {
+            fprintf(stderr, "g722_pcap: %s and %s: ssrc %08x of both would go to the same file\n",
+              t.streams[i - 1]->cap->path, t.streams[i]->cap->path, (unsigned int)t.streams[i]->ssrc);
+            exit (1);
+        }
+    }
+    qsort(t.streams, t.nstreams, sizeof(t.streams[0]), stream_cmp);
+    pool_run(decode_stream, &t, t.nstreams, nthreads);
+
+    failed = 0;
+    for (i = 0; i < t.nstreams; i++) {
+        failed |= t.streams[i]->failed;
+        free(t.streams[i]->pkt);
+        free(t.streams[i]);
+    }
+    for (i = 0; i < t.ncaps; i++) {
+        failed |= t.caps[i].failed;
+        if (t.caps[i].data != NULL)
+            unmap_capture(&t.caps[i]);
+        free(t.caps[i].streams);
+    }
+    free(t.streams);
+    free(t.caps);
+    return (failed) ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 Sippy Software, Inc., http://www.sippysoft.com
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/*
+ * The worker pool of the command line tools: a fixed number of threads
+ * that take the items of a batch in turn until none are left. How many
+ * threads to start by default is g722_engine_cpus().
+ */
+
+#pragma once
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+
+struct pool {
+    void (*fn)(void *arg, int i);
+    void *arg;
+    int n;
+    long next;
+};
+
+static void
+run_pool(struct pool *p)
+{
+    long i;
+
+    for (;;) {
+#if defined(_WIN32)
+        i = InterlockedIncrement(&p->next) - 1;
+#else
+        i = __atomic_fetch_add(&p->next, 1, __ATOMIC_RELAXED);
+#endif
+        if (i >= p->n)
+            break;
+        p->fn(p->arg, (int)i);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI
+pool_thread(LPVOID arg)
+{
+
+    run_pool((struct pool *)arg);
+    return 0;
+}
+#else
+static void *
+pool_thread(void *arg)
+{
+
+    run_pool((struct pool *)arg);
+    return NULL;
+}
+#endif
+
+/* Call fn for each of n items, on up to nthreads threads. Where a thread
+   cannot be had, the calling thread does its share */
+static void
+pool_run(void (*fn)(void *, int), void *arg, int n, int nthreads)
+{
+    struct pool p;
+#if defined(_WIN32)
+    HANDLE *th;
+#else
+    pthread_t *th;
+#endif
+    int i, started;
+
+    memset(&p, 0, sizeof(p));
+    p.fn = fn;
+    p.arg = arg;
+    p.n = n;
+    if (nthreads > n)
+        nthreads = n;
+    if (nthreads <= 1) {
+        run_pool(&p);
+        return;
+    }
+    th = malloc(nthreads * sizeof(*th));
+#if defined(_WIN32)
+    for (started = 0; th != NULL && started < nthreads; started++) {
+        th[started] = CreateThread(NULL, 0, pool_thread, &p, 0, NULL);
+        if (th[started] == NULL)
+            break;
+    }
+#else
+    for (started = 0; th != NULL && started < nthreads; started++) {
+        if (pthread_create(&th[started], NULL, pool_thread, &p) != 0)
+            break;
+    }
+#endif
+    /* Whatever the threads that did not start would have done */
+    if (started < nthreads)
+        run_pool(&p);
+    for (i = 0; i < started; i++) {
+#if defined(_WIN32)
+        WaitForSingleObject(th[i], INFINITE);
+        CloseHandle(th[i]);
+#else
+        pthread_join(th[i], NULL);
+#endif
+    }
+    free(th);
+}